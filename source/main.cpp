@@ -188,6 +188,7 @@ static tsl::elm::ListItem* selectedListItem;
 static tsl::elm::ListItem* lastSelectedListItem;
 
 static std::atomic<bool> lastRunningInterpreter{false};
+static std::atomic<bool> softwareUpdateSucceeded{false};  // set by the update job's completion callback
 
 static Result setGlobalRegion() {
     Result rc;
@@ -306,6 +307,7 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
         abortUnzip.store(true, release);
         abortFileOp.store(true, release);
         abortCommand.store(true, release);
+        cancelQueuedInterpreterJobs();
         externalAbortCommands.store(false, release);
         // Reset UI state
         commandSuccess.store(false, release);
@@ -338,6 +340,21 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
     static std::atomic<int>* const pcts[] = {&downloadPercentage, &unzipPercentage, &copyPercentage};
     static const std::string* const syms[] = {&DOWNLOAD_SYMBOL, &UNZIP_SYMBOL, &COPY_SYMBOL};
     
+    // Parallel blocks report overall progress across all of their tasks (pseudo operation 3)
+    const int parallelTotal = parallelTasksTotal.load(acquire);
+    if (parallelTotal > 0) {
+        const int parallelPct = parallelTasksCompleted.load(acquire) * 100 / parallelTotal;
+        if (parallelPct != lastPct || lastOp != 3) {
+            displayPercentage.store(parallelPct, release);
+            if (lastSelectedListItem)
+                lastSelectedListItem->setValue(INPROGRESS_SYMBOL + " " + ult::to_string(parallelPct) + "%");
+            lastPct = parallelPct;
+            lastOp = 3;
+            inProg = true;
+        }
+        return false;
+    }
+    
     int currentPct = -1;
     uint8_t currentOp = 255;
     
@@ -531,6 +548,7 @@ private:
                         downloadFile(INCLUDED_THEME_FOLDER_URL+"ultra-blue.ini", THEMES_PATH, false, true);
                     }
                 }
+                clearDirectoryListingCache();
 
                 tsl::shiftItemFocus(listItem);
                 tsl::changeTo<UltrahandSettingsMenu>(targetMenu);
@@ -684,21 +702,12 @@ private:
             listItem->setValueColor(tsl::onTextColor);
     
         listItem->setClickListener([this, listItem](uint64_t keys) {
-            static bool executingCommands = false;
-            if (runningInterpreter.load(acquire)) {
+            if (runningInterpreter.load(acquire))
                 return false;
-            } else {
-                if (executingCommands && commandSuccess.load(acquire)) {
-                    softwareHasUpdated = true;
-                    triggerMenuReload = true;
-                }
-                executingCommands = false;
-            }
         
             if (!(keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK)))
                 return false;
             
-            executingCommands = true;
             isDownloadCommand.store(true, release);
         
             const bool disableLoaderUpdate = isFile(FLAGS_PATH + "NO_LOADER_UPDATES.flag");
@@ -765,7 +774,10 @@ private:
             addRestore();
         
             runningInterpreter.store(true, release);
-            executeInterpreterCommands(std::move(cmds), "", "");
+            executeInterpreterCommands(std::move(cmds), "", "", [](u32, bool success) {
+                if (success)
+                    softwareUpdateSucceeded.store(true, release);
+            });
             listItem->disableClickAnimation();
             listItem->setValue(INPROGRESS_SYMBOL);
             lastSelectedListItem = listItem;
@@ -1364,7 +1376,7 @@ public:
             });
             list->addItem(listItem);
 
-            filesList = getFilesListByWildcards(THEMES_PATH + "*.ini");
+            filesList = getCachedFilesListByWildcards(THEMES_PATH + "*.ini");
             std::sort(filesList.begin(), filesList.end());
 
             std::string themeName;
@@ -1426,6 +1438,7 @@ public:
                 if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
                     setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_sounds", OPTION_SYMBOL);
                     deleteFileOrDirectoryByPattern(LOADED_SOUNDS_PATH+"*.wav");
+                    clearDirectoryListingCache();
                     ult::Audio::unloadAllSounds({});
 
                     setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "sound_effects", FALSE_STR);
@@ -1443,7 +1456,7 @@ public:
             });
             list->addItem(listItem);
         
-            filesList = getFilesListByWildcards(SOUNDS_PATH + "*.zip");
+            filesList = getCachedFilesListByWildcards(SOUNDS_PATH + "*.zip");
             std::sort(filesList.begin(), filesList.end());
         
             for (auto it = filesList.begin(); it != filesList.end(); ++it) {
@@ -1470,6 +1483,7 @@ public:
                         setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_sounds", soundsName);
                         deleteFileOrDirectoryByPattern(LOADED_SOUNDS_PATH+"*.wav");
                         unzipFile(soundsFile, LOADED_SOUNDS_PATH);
+                        clearDirectoryListingCache();
                         
                         setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "sound_effects", TRUE_STR);
                         useSoundEffects = true;
@@ -1507,6 +1521,7 @@ public:
                 if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
                     setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper", "");
                     deleteFileOrDirectory(WALLPAPER_PATH);
+                    clearDirectoryListingCache();
                     reloadWallpaper();
                     if (lastSelectedListItem)
                         lastSelectedListItem->setValue("");
@@ -1523,7 +1538,7 @@ public:
             });
             list->addItem(listItem);
 
-            filesList = getFilesListByWildcards(WALLPAPERS_PATH + "*.rgba");
+            filesList = getCachedFilesListByWildcards(WALLPAPERS_PATH + "*.rgba");
             std::sort(filesList.begin(), filesList.end());
 
             std::string wallpaperName;
@@ -1544,6 +1559,7 @@ public:
                         setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper", wallpaperName);
                         copyFileOrDirectory(wallpaperFile, WALLPAPER_PATH);
                         copyPercentage.store(-1, release);
+                        clearDirectoryListingCache();
                         reloadWallpaper();
                         if (lastSelectedListItem)
                             lastSelectedListItem->setValue("");
@@ -1697,6 +1713,11 @@ public:
             }, nullptr, true);  // <-- resetStoredCommands = true
         }
 
+        if (softwareUpdateSucceeded.exchange(false, std::memory_order_acq_rel)) {
+            softwareHasUpdated = true;
+            triggerMenuReload = true;
+        }
+
         const bool isRunningInterp = runningInterpreter.load(acquire);
         
         if (isRunningInterp) {
@@ -1711,7 +1732,7 @@ public:
                 lastSelectedListItem = nullptr;
             }
 
-            closeInterpreterThread();
+            clearInterpreterFlags();
             resetPercentages();
 
             if (!commandSuccess.load()) {
@@ -2359,6 +2380,7 @@ public:
                 if (hasTarget) {
                     deleteFileOrDirectory(targetPath);
                     removeIniSection(settingsIniPath, entryName);
+                    clearDirectoryListingCache();
         
                     if (lastSelectedListItem) {
                         lastSelectedListItem->setValue(CHECKMARK_SYMBOL);
@@ -2633,6 +2655,27 @@ public:
                 index++;
                 command = {};
             }
+
+            // Show per-command timings from the last profiled run of this package
+            const std::vector<CommandProfileRecord> profile = getCommandProfile(filePath);
+            if (!profile.empty()) {
+                std::vector<std::string> sectionLines;
+                std::vector<std::string> infoLines;
+                sectionLines.reserve(profile.size());
+                infoLines.reserve(profile.size());
+
+                char timeBuffer[32];
+                for (const auto& record : profile) {
+                    sectionLines.emplace_back(record.name);
+                    snprintf(timeBuffer, sizeof(timeBuffer), "%.2f ms", static_cast<double>(record.wallNs) / 1000000.0);
+                    infoLines.emplace_back(timeBuffer);
+                }
+
+                std::vector<std::vector<std::string>> dummyTableData;
+                addHeader(list, "Profile");
+                drawTable(list, dummyTableData, sectionLines, infoLines, 163, 20, 9, 4,
+                          DEFAULT_STR, DEFAULT_STR, DEFAULT_STR, LEFT_STR, false, false, false, true, "char", true);
+            }
         } else {
 
             noClickableItems = true;
@@ -2728,7 +2771,7 @@ public:
                 lastSelectedListItem->enableClickAnimation();
                 lastSelectedListItem = nullptr;
             }
-            closeInterpreterThread();
+            clearInterpreterFlags();
 
             if (!commandSuccess.load()) {
                 triggerRumbleDoubleClick.store(true, std::memory_order_release);
@@ -2941,7 +2984,7 @@ public:
 
             // Apply placeholder replacements in-place
             for (auto& arg : cmd) {
-                replacePlaceholdersInArg(arg, generalPlaceholders);
+                replaceGeneralPlaceholders(arg);
             }
 
             const std::string& commandName = cmd[0]; // Now assigns to string_view - no copy
@@ -3032,7 +3075,7 @@ public:
                         if (filterEntry.find('*') != std::string::npos) {
                             // Get files directly into temporary, avoid intermediate storage
                             tempFiles.clear();
-                            tempFiles = getFilesListByWildcards(filterEntry, maxItemsLimit);
+                            tempFiles = getCachedFilesListByWildcards(filterEntry, maxItemsLimit);
                             if (currentSection == GLOBAL_STR) {
                                 filterList.insert(filterList.end(), 
                                                 std::make_move_iterator(tempFiles.begin()),
@@ -3060,11 +3103,10 @@ public:
                         if (currentSection == GLOBAL_STR) {
                             pathPattern = cmd[1];
                             preprocessPath(pathPattern, filePath);
-                            updateGeneralPlaceholders();
-                            replacePlaceholdersInArg(pathPattern, generalPlaceholders);
+                            replaceGeneralPlaceholders(pathPattern);
                             // Get files directly, avoid storing in intermediate variable
                             tempFiles.clear();
-                            tempFiles = getFilesListByWildcards(pathPattern, maxItemsLimit);
+                            tempFiles = getCachedFilesListByWildcards(pathPattern, maxItemsLimit);
                             filesList.insert(filesList.end(), 
                                            std::make_move_iterator(tempFiles.begin()),
                                            std::make_move_iterator(tempFiles.end()));
@@ -3072,7 +3114,7 @@ public:
                             pathPatternOn = cmd[1];
                             preprocessPath(pathPatternOn, filePath);
                             tempFiles.clear();
-                            tempFiles = getFilesListByWildcards(pathPatternOn, maxItemsLimit);
+                            tempFiles = getCachedFilesListByWildcards(pathPatternOn, maxItemsLimit);
                             filesListOn.insert(filesListOn.end(), 
                                              std::make_move_iterator(tempFiles.begin()),
                                              std::make_move_iterator(tempFiles.end()));
@@ -3081,7 +3123,7 @@ public:
                             pathPatternOff = cmd[1];
                             preprocessPath(pathPatternOff, filePath);
                             tempFiles.clear();
-                            tempFiles = getFilesListByWildcards(pathPatternOff, maxItemsLimit);
+                            tempFiles = getCachedFilesListByWildcards(pathPatternOff, maxItemsLimit);
                             filesListOff.insert(filesListOff.end(), 
                                               std::make_move_iterator(tempFiles.begin()),
                                               std::make_move_iterator(tempFiles.end()));
@@ -3791,7 +3833,7 @@ public:
                 lastSelectedListItem->enableClickAnimation();
             }
         
-            closeInterpreterThread();
+            clearInterpreterFlags();
             resetPercentages();
             
 
@@ -4169,10 +4211,7 @@ bool drawCommandsMenu(
     bool isMini;
     const bool isDocked = ult::consoleIsDocked();
 
-    // update general placeholders
-    updateGeneralPlaceholders();
-
-    std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options = loadOptionsFromIni(packageIniPath);
+    std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options = loadOptionsFromIniCached(packageIniPath);
     for (size_t i = 0; i < options.size(); ++i) {
         optionName.clear();
         commands.clear();
@@ -4430,7 +4469,7 @@ bool drawCommandsMenu(
                                 } else if (keys & SCRIPT_KEY && !(keys & ~SCRIPT_KEY & ALL_KEYS_MASK)) {
                                     // Pass all gathered commands to the ScriptOverlay
                                     tsl::shiftItemFocus(listItem);
-                                    tsl::changeTo<ScriptOverlay>(std::move(gatherPromptCommands(optionName, std::move(loadOptionsFromIni(packageIniPath)))), packagePath, optionName, "package", true, lastPackageHeader, showWidget);
+                                    tsl::changeTo<ScriptOverlay>(std::move(gatherPromptCommands(optionName, std::move(loadOptionsFromIniCached(packageIniPath)))), packagePath, optionName, "package", true, lastPackageHeader, showWidget);
                                     return true;
                                 }
                                 return false;
@@ -4455,7 +4494,7 @@ bool drawCommandsMenu(
                                     
                                     // Gather the prompt commands for the current dropdown section
                                     tsl::shiftItemFocus(listItem);
-                                    tsl::changeTo<ScriptOverlay>(std::move(gatherPromptCommands(optionName, std::move(loadOptionsFromIni(packageIniPath)))), PACKAGE_PATH, optionName, "main", true, lastPackageHeader, showWidget);
+                                    tsl::changeTo<ScriptOverlay>(std::move(gatherPromptCommands(optionName, std::move(loadOptionsFromIniCached(packageIniPath)))), PACKAGE_PATH, optionName, "main", true, lastPackageHeader, showWidget);
                                     return true;
                                 } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
                                     skipJumpReset.store(false, std::memory_order_release);
@@ -5864,7 +5903,7 @@ public:
                 lastFooterHighlight = lastFooterHighlightDefined = false;
             }
         
-            closeInterpreterThread();
+            clearInterpreterFlags();
             resetPercentages();
             
 
@@ -5880,7 +5919,7 @@ public:
         }
 
         if (ult::refreshWallpaperNow.exchange(false, std::memory_order_acq_rel)) {
-            closeInterpreterThread();
+            clearInterpreterFlags();
             ult::reloadWallpaper();
             if (!limitedMemory && useSoundEffects) {
                 reloadSoundCacheNow.store(true, std::memory_order_release);
@@ -6358,7 +6397,7 @@ public:
 
         addHeader(list, (!inHiddenMode.load(std::memory_order_acquire) ? OVERLAYS : HIDDEN_OVERLAYS)+" "+DIVIDER_SYMBOL+" \uE0E3 "+SETTINGS+" "+DIVIDER_SYMBOL+" \uE0E2 "+FAVORITE);
         
-        std::vector<std::string> overlayFiles = getFilesListByWildcards(OVERLAY_PATH+"*.ovl");
+        std::vector<std::string> overlayFiles = getCachedFilesListByWildcards(OVERLAY_PATH+"*.ovl");
         
         if (!isFile(OVERLAYS_INI_FILEPATH)) {
             FILE* createFile = fopen(OVERLAYS_INI_FILEPATH.c_str(), "w");
@@ -7237,7 +7276,7 @@ public:
                 lastFooterHighlight = lastFooterHighlightDefined = false;
             }
         
-            closeInterpreterThread();
+            clearInterpreterFlags();
             resetPercentages();
 
             if (!commandSuccess.load()) {
@@ -7251,7 +7290,7 @@ public:
         }
         
         if (ult::refreshWallpaperNow.exchange(false, std::memory_order_acq_rel)) {
-            closeInterpreterThread();
+            clearInterpreterFlags();
             ult::reloadWallpaper();
 
             if (!limitedMemory && useSoundEffects) {
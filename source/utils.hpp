@@ -25,10 +25,15 @@
 
 #include <stdio.h>
 #include <fnmatch.h>
+#include <dirent.h>
 #include <numeric>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <malloc.h>
+#include <cmath>
+#include <sys/statvfs.h>
+#include <cerrno>
 
 
 using namespace ult;
@@ -521,6 +526,220 @@ void removeEmptyCommands(std::vector<std::vector<std::string>>& commands) {
 }
 
 
+/**
+ * @brief Binary cache of parsed package.ini option tables.
+ *
+ * Each package.ini gets one cache file under `sdmc:/config/ultrahand/cache/`, named after a hash
+ * of its path. The cache stores the source file's size and mtime; if either changes the cache is
+ * rebuilt. A valid cache is loaded with a single read and decoded in place.
+ *
+ * Layout (native endian):
+ *   OptionsCacheHeader
+ *   per option:  u32 nameLen, name bytes, u32 commandCount
+ *     per command: u32 tokenCount
+ *       per token: u32 tokenLen, token bytes
+ */
+static constexpr u32 OPTIONS_CACHE_MAGIC = 0x434F4855; // "UHOC"
+static constexpr u32 OPTIONS_CACHE_VERSION = 1;
+
+struct OptionsCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 sourceSize;
+    s64 sourceMtime;
+    u32 optionCount;
+    u32 payloadSize;
+};
+
+inline std::string getOptionsCachePath(const std::string& iniPath) {
+    char name[32];
+    snprintf(name, sizeof(name), "options_%016llx.bin", static_cast<unsigned long long>(std::hash<std::string>{}(iniPath)));
+    return SETTINGS_PATH + "cache/" + name;
+}
+
+/**
+ * @brief Moves a fully written temp file over its target.
+ *
+ * rename() cannot replace an existing file on every filesystem, so the target is moved aside
+ * first and moved back if the temp file cannot take its place. On failure the temp file is kept.
+ *
+ * @return true if the target now holds the temp file's contents.
+ */
+inline bool replaceFileWithTemp(const std::string& tempPath, const std::string& targetPath) {
+    const std::string backupPath = targetPath + ".bak";
+    remove(backupPath.c_str());
+    const bool movedAside = rename(targetPath.c_str(), backupPath.c_str()) == 0;
+
+    if (rename(tempPath.c_str(), targetPath.c_str()) != 0) {
+        if (movedAside)
+            rename(backupPath.c_str(), targetPath.c_str());
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging)
+            logMessage("Failed to replace " + targetPath + ", kept " + tempPath);
+        #endif
+        return false;
+    }
+
+    if (movedAside)
+        remove(backupPath.c_str());
+    return true;
+}
+
+inline void appendCacheString(std::string& buffer, const std::string& str) {
+    const u32 len = static_cast<u32>(str.size());
+    buffer.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    buffer.append(str);
+}
+
+inline bool readCacheU32(const char*& cursor, const char* end, u32& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(u32)) return false;
+    std::memcpy(&value, cursor, sizeof(u32));
+    cursor += sizeof(u32);
+    return true;
+}
+
+inline bool readCacheString(const char*& cursor, const char* end, std::string& str) {
+    u32 len;
+    if (!readCacheU32(cursor, end, len) || static_cast<size_t>(end - cursor) < len) return false;
+    str.assign(cursor, len);
+    cursor += len;
+    return true;
+}
+
+bool readOptionsCache(const std::string& cachePath, const struct stat& sourceStat,
+                      std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>>& options) {
+    FILE* file = fopen(cachePath.c_str(), "rb");
+    if (!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    const long fileSize = ftell(file);
+    if (fileSize < static_cast<long>(sizeof(OptionsCacheHeader))) {
+        fclose(file);
+        return false;
+    }
+    fseek(file, 0, SEEK_SET);
+
+    // One read for the whole cache
+    std::string data(static_cast<size_t>(fileSize), '\0');
+    const bool readOk = fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    if (!readOk) return false;
+
+    OptionsCacheHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != OPTIONS_CACHE_MAGIC || header.version != OPTIONS_CACHE_VERSION ||
+        header.sourceSize != static_cast<u64>(sourceStat.st_size) ||
+        header.sourceMtime != static_cast<s64>(sourceStat.st_mtime) ||
+        header.payloadSize != data.size() - sizeof(header)) {
+        return false;
+    }
+
+    const char* cursor = data.data() + sizeof(header);
+    const char* end = data.data() + data.size();
+
+    // Every count is checked against the bytes left before anything is allocated for it:
+    // an option takes at least 8 bytes, a command and a token at least 4
+    const auto fits = [&](u32 count, size_t minSize) {
+        return count <= static_cast<size_t>(end - cursor) / minSize;
+    };
+
+    options.clear();
+    if (!fits(header.optionCount, 2 * sizeof(u32)))
+        return false;
+    options.resize(header.optionCount);
+
+    u32 commandCount, tokenCount;
+    for (auto& option : options) {
+        if (!readCacheString(cursor, end, option.first) || !readCacheU32(cursor, end, commandCount) ||
+            !fits(commandCount, sizeof(u32))) {
+            options.clear();
+            return false;
+        }
+        option.second.resize(commandCount);
+        for (auto& cmd : option.second) {
+            if (!readCacheU32(cursor, end, tokenCount) || !fits(tokenCount, sizeof(u32))) {
+                options.clear();
+                return false;
+            }
+            cmd.resize(tokenCount);
+            for (auto& token : cmd) {
+                if (!readCacheString(cursor, end, token)) {
+                    options.clear();
+                    return false;
+                }
+            }
+        }
+    }
+    return cursor == end;
+}
+
+void writeOptionsCache(const std::string& cachePath, const struct stat& sourceStat,
+                       const std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>>& options) {
+    std::string payload;
+    for (const auto& [name, commands] : options) {
+        appendCacheString(payload, name);
+        const u32 commandCount = static_cast<u32>(commands.size());
+        payload.append(reinterpret_cast<const char*>(&commandCount), sizeof(commandCount));
+        for (const auto& cmd : commands) {
+            const u32 tokenCount = static_cast<u32>(cmd.size());
+            payload.append(reinterpret_cast<const char*>(&tokenCount), sizeof(tokenCount));
+            for (const auto& token : cmd) {
+                appendCacheString(payload, token);
+            }
+        }
+    }
+
+    const OptionsCacheHeader header = {
+        OPTIONS_CACHE_MAGIC,
+        OPTIONS_CACHE_VERSION,
+        static_cast<u64>(sourceStat.st_size),
+        static_cast<s64>(sourceStat.st_mtime),
+        static_cast<u32>(options.size()),
+        static_cast<u32>(payload.size())
+    };
+
+    createDirectory(getParentDirFromPath(cachePath));
+
+    // Write to a temp file first so a partial write never looks like a valid cache
+    const std::string tempPath = cachePath + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return;
+
+    const bool writeOk = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                         fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    fclose(file);
+
+    if (!writeOk) {
+        remove(tempPath.c_str());
+        return;
+    }
+    replaceFileWithTemp(tempPath, cachePath);
+}
+
+/**
+ * @brief Loads the option table of a package.ini, using the on-disk cache when it is still valid.
+ *
+ * @param iniPath Path to the package.ini file.
+ * @return The same result as loadOptionsFromIni(iniPath).
+ */
+std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> loadOptionsFromIniCached(const std::string& iniPath) {
+    struct stat sourceStat;
+    if (stat(iniPath.c_str(), &sourceStat) != 0) {
+        return loadOptionsFromIni(iniPath);
+    }
+
+    const std::string cachePath = getOptionsCachePath(iniPath);
+
+    std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options;
+    if (readOptionsCache(cachePath, sourceStat, options)) {
+        return options;
+    }
+
+    options = loadOptionsFromIni(iniPath);
+    writeOptionsCache(cachePath, sourceStat, options);
+    return options;
+}
+
 
 
 // Define the helper function
@@ -2105,6 +2324,94 @@ bool isDangerousCombination(const std::string& originalPath) {
 }
 
 
+/**
+ * @brief Small LRU cache of parsed JSON documents for json/json_file placeholders and sources.
+ *
+ * Files are keyed by path, size and mtime, inline JSON by a hash of its text. Documents are
+ * shared, so an entry evicted while a caller still reads it stays alive until released.
+ * Under limitedMemory only one small document is kept.
+ */
+struct CachedJsonDocument {
+    std::string path;   // empty for inline JSON
+    u64 contentHash;    // inline JSON only
+    s64 size;
+    s64 mtime;
+    std::shared_ptr<json_t> document;
+};
+
+static constexpr size_t JSON_DOCUMENT_CACHE_LIMIT = 4;
+static constexpr s64 JSON_DOCUMENT_CACHE_MAX_BYTES = 512 * 1024;
+static std::vector<CachedJsonDocument> jsonDocumentCache;  // most recently used first
+static std::mutex jsonDocumentCacheMutex;
+
+void clearJsonDocumentCache() {
+    std::lock_guard<std::mutex> lock(jsonDocumentCacheMutex);
+    jsonDocumentCache.clear();
+}
+
+void invalidateCachedJsonDocument(const std::string& path) {
+    std::lock_guard<std::mutex> lock(jsonDocumentCacheMutex);
+    jsonDocumentCache.erase(std::remove_if(jsonDocumentCache.begin(), jsonDocumentCache.end(),
+        [&](const CachedJsonDocument& entry) { return entry.path == path; }), jsonDocumentCache.end());
+}
+
+/**
+ * @brief Returns the parsed document for a JSON file or inline JSON string, parsing it at most once.
+ *
+ * @param jsonPathOrString File path if isFile is true, otherwise the JSON text.
+ * @return The document, or nullptr if it could not be read or parsed.
+ */
+std::shared_ptr<json_t> getCachedJsonDocument(const std::string& jsonPathOrString, bool isFile) {
+    s64 size = static_cast<s64>(jsonPathOrString.size());
+    s64 mtime = 0;
+    u64 contentHash = 0;
+    
+    if (isFile) {
+        struct stat st;
+        if (stat(jsonPathOrString.c_str(), &st) != 0)
+            return nullptr;
+        size = static_cast<s64>(st.st_size);
+        mtime = static_cast<s64>(st.st_mtime);
+    } else {
+        contentHash = std::hash<std::string>{}(jsonPathOrString);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(jsonDocumentCacheMutex);
+        for (auto it = jsonDocumentCache.begin(); it != jsonDocumentCache.end(); ++it) {
+            const bool matches = isFile ? (it->path == jsonPathOrString && it->mtime == mtime)
+                                        : (it->path.empty() && it->contentHash == contentHash);
+            if (matches && it->size == size) {
+                std::rotate(jsonDocumentCache.begin(), it, it + 1);
+                return jsonDocumentCache.front().document;
+            }
+        }
+    }
+    
+    std::shared_ptr<json_t> document(isFile ? readJsonFromFile(jsonPathOrString) : stringToJson(jsonPathOrString), JsonDeleter());
+    if (!document)
+        return nullptr;
+    
+    const s64 maxBytes = ult::limitedMemory ? JSON_DOCUMENT_CACHE_MAX_BYTES / 8 : JSON_DOCUMENT_CACHE_MAX_BYTES;
+    if (size > maxBytes)
+        return document;  // too large to keep around
+    
+    std::lock_guard<std::mutex> lock(jsonDocumentCacheMutex);
+    if (isFile) {
+        // Drop the stale version of this file
+        jsonDocumentCache.erase(std::remove_if(jsonDocumentCache.begin(), jsonDocumentCache.end(),
+            [&](const CachedJsonDocument& entry) { return entry.path == jsonPathOrString; }), jsonDocumentCache.end());
+    }
+    jsonDocumentCache.insert(jsonDocumentCache.begin(),
+        CachedJsonDocument{isFile ? jsonPathOrString : std::string(), contentHash, size, mtime, document});
+    
+    const size_t limit = ult::limitedMemory ? 1 : JSON_DOCUMENT_CACHE_LIMIT;
+    if (jsonDocumentCache.size() > limit)
+        jsonDocumentCache.resize(limit);
+    return document;
+}
+
+
 // Function to populate selectedItemsListOff from a JSON array based on a key
 void populateSelectedItemsListFromJson(const std::string& sourceType, const std::string& jsonStringOrPath, const std::string& jsonKey, std::vector<std::string>& selectedItemsList) {
     selectedItemsList.clear();
@@ -2113,13 +2420,12 @@ void populateSelectedItemsListFromJson(const std::string& sourceType, const std:
     if (jsonStringOrPath.empty()) {
         return;
     }
-    // Use a unique_ptr to manage JSON object with appropriate deleter
-    std::unique_ptr<json_t, JsonDeleter> jsonData(nullptr, JsonDeleter());
-    // Convert JSON string or read from file based on the source type
+    // Parsed documents are shared through the JSON document cache
+    std::shared_ptr<json_t> jsonData;
     if (sourceType == JSON_STR) {
-        jsonData.reset(stringToJson(jsonStringOrPath));
+        jsonData = getCachedJsonDocument(jsonStringOrPath, false);
     } else if (sourceType == JSON_FILE_STR) {
-        jsonData.reset(readJsonFromFile(jsonStringOrPath));
+        jsonData = getCachedJsonDocument(jsonStringOrPath, true);
     }
     // Early return if jsonData is null or not an array
     if (!jsonData) {
@@ -2173,6 +2479,70 @@ inline void applyPlaceholderReplacement(std::string& input, const std::string& p
 
 
 
+/**
+ * @brief Cached index of an INI file (section -> key -> value, plus section order) for the
+ * {ini_file(...)} and {ini_file_source(...)} placeholders.
+ *
+ * Indexes are keyed by path, size and mtime and kept in a small LRU shared by the UI thread and
+ * the interpreter. INI commands invalidate the file they write.
+ */
+struct IniFileIndex {
+    std::string path;
+    s64 size = 0;
+    s64 mtime = 0;
+    decltype(ult::getParsedDataFromIniFile(std::string())) sections;
+    std::vector<std::string> sectionOrder;
+};
+
+static constexpr size_t INI_INDEX_CACHE_LIMIT = 4;
+static std::vector<std::shared_ptr<const IniFileIndex>> iniIndexCache;  // most recently used first
+static std::mutex iniIndexMutex;
+
+void invalidateIniIndex(const std::string& path) {
+    std::lock_guard<std::mutex> lock(iniIndexMutex);
+    iniIndexCache.erase(std::remove_if(iniIndexCache.begin(), iniIndexCache.end(),
+        [&](const std::shared_ptr<const IniFileIndex>& index) { return index->path == path; }), iniIndexCache.end());
+}
+
+void clearIniIndexCache() {
+    std::lock_guard<std::mutex> lock(iniIndexMutex);
+    iniIndexCache.clear();
+}
+
+static std::shared_ptr<const IniFileIndex> getIniIndex(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return nullptr;
+    const s64 size = static_cast<s64>(st.st_size);
+    const s64 mtime = static_cast<s64>(st.st_mtime);
+
+    std::lock_guard<std::mutex> lock(iniIndexMutex);
+    for (auto it = iniIndexCache.begin(); it != iniIndexCache.end(); ++it) {
+        if ((*it)->path == path) {
+            if ((*it)->size == size && (*it)->mtime == mtime) {
+                std::rotate(iniIndexCache.begin(), it, it + 1);
+                return iniIndexCache.front();
+            }
+            iniIndexCache.erase(it);  // stale
+            break;
+        }
+    }
+
+    auto index = std::make_shared<IniFileIndex>();
+    index->path = path;
+    index->size = size;
+    index->mtime = mtime;
+    index->sections = ult::getParsedDataFromIniFile(path);
+    index->sectionOrder = parseSectionsFromIni(path);
+
+    iniIndexCache.insert(iniIndexCache.begin(), index);
+    const size_t limit = ult::limitedMemory ? 1 : INI_INDEX_CACHE_LIMIT;
+    if (iniIndexCache.size() > limit)
+        iniIndexCache.resize(limit);
+    return index;
+}
+
+
 void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName, const std::string& iniPath) {
     const std::string searchString = "{" + commandName + "(";
     
@@ -2191,9 +2561,8 @@ void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName
     std::string iniSection;
     std::string iniKey;
     
-    // Cache section names to avoid re-parsing INI file multiple times
-    std::vector<std::string> sectionNames;
-    bool sectionsLoaded = false;
+    // Every lookup is served from the cached index of the file
+    const auto index = getIniIndex(iniPath);
     
     // Build result incrementally to avoid expensive string replacement operations
     std::string result;
@@ -2229,7 +2598,15 @@ void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName
             trim(iniKey);
             removeQuotes(iniKey);
             
-            replacement = returnOrNull(parseValueFromIniSection(iniPath, iniSection, iniKey));
+            replacement = NULL_STR;
+            if (index) {
+                const auto sectionIt = index->sections.find(iniSection);
+                if (sectionIt != index->sections.end()) {
+                    const auto keyIt = sectionIt->second.find(iniKey);
+                    if (keyIt != sectionIt->second.end())
+                        replacement = returnOrNull(keyIt->second);
+                }
+            }
         } else {
             // Check if the content is an integer
             if (std::all_of(placeholderContent.begin(), placeholderContent.end(), ::isdigit)) {
@@ -2238,14 +2615,8 @@ void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName
                 } else {
                     entryIndex = ult::stoi(placeholderContent);
                     
-                    // Load section names only once when needed
-                    if (!sectionsLoaded) {
-                        sectionNames = parseSectionsFromIni(iniPath);
-                        sectionsLoaded = true;
-                    }
-                    
-                    if (entryIndex < sectionNames.size()) {
-                        replacement = sectionNames[entryIndex];
+                    if (index && entryIndex < index->sectionOrder.size()) {
+                        replacement = index->sectionOrder[entryIndex];
                     } else {
                         replacement = NULL_STR;
                     }
@@ -2290,11 +2661,11 @@ std::string replaceJsonPlaceholder(const std::string& arg, const std::string& co
     }
     
     // Load JSON data only if we have placeholders to process
-    std::unique_ptr<json_t, JsonDeleter> jsonDict;
+    std::shared_ptr<json_t> jsonDict;
     if (commandName == "json" || commandName == "json_source") {
-        jsonDict.reset(stringToJson(jsonPathOrString));
+        jsonDict = getCachedJsonDocument(jsonPathOrString, false);
     } else if (commandName == "json_file" || commandName == "json_file_source") {
-        jsonDict.reset(readJsonFromFile(jsonPathOrString));
+        jsonDict = getCachedJsonDocument(jsonPathOrString, true);
     }
     if (!jsonDict) {
         return arg; // Return original string if JSON data couldn't be loaded
@@ -2402,177 +2773,516 @@ bool replacePlaceholdersInArg(std::string& source, const std::unordered_map<std:
 }
 
 
-// Optimized getSourceReplacement function
-std::vector<std::vector<std::string>> getSourceReplacement(const std::vector<std::vector<std::string>>& commands,
-    const std::string& entry, size_t entryIndex, const std::string& packagePath = "") {
+/**
+ * @brief Line-offset index for list files, so {list_file(N)} and {list_file_source(*)} can
+ * fetch any line with one seek and read instead of rescanning the file up to line N.
+ *
+ * Indexes are built on first access, validated by size and mtime, and kept in a small LRU
+ * shared by the UI thread and the interpreter.
+ */
+struct ListFileIndex {
+    std::string path;
+    s64 size = 0;
+    s64 mtime = 0;
+    std::vector<u32> lineOffsets;  // start offset of every line
+};
 
-    bool inEristaSection = false;
-    bool inMarikoSection = false;
+static constexpr size_t LIST_FILE_INDEX_CACHE_LIMIT = 4;
+static std::vector<std::shared_ptr<const ListFileIndex>> listFileIndexCache;  // most recently used first
+static std::mutex listFileIndexMutex;
+
+static std::shared_ptr<const ListFileIndex> buildListFileIndex(const std::string& path, s64 size, s64 mtime) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return nullptr;
+
+    auto index = std::make_shared<ListFileIndex>();
+    index->path = path;
+    index->size = size;
+    index->mtime = mtime;
+
+    static constexpr size_t CHUNK_SIZE = 4096;
+    char chunk[CHUNK_SIZE];
+    size_t bytesRead;
+    u32 offset = 0;
+    bool atLineStart = true;
+
+    while ((bytesRead = fread(chunk, 1, CHUNK_SIZE, file)) > 0) {
+        for (size_t i = 0; i < bytesRead; ++i) {
+            if (atLineStart) {
+                index->lineOffsets.push_back(offset + static_cast<u32>(i));
+                atLineStart = false;
+            }
+            if (chunk[i] == '\n')
+                atLineStart = true;
+        }
+        offset += static_cast<u32>(bytesRead);
+    }
+    fclose(file);
+    return index;
+}
 
-    std::vector<std::vector<std::string>> modifiedCommands;
-    std::string listString, listPath, jsonString, jsonPath, iniPath;
-    bool usingFileSource = false;
+static std::shared_ptr<const ListFileIndex> getListFileIndex(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return nullptr;
+    const s64 size = static_cast<s64>(st.st_size);
+    const s64 mtime = static_cast<s64>(st.st_mtime);
+
+    std::lock_guard<std::mutex> lock(listFileIndexMutex);
+    for (auto it = listFileIndexCache.begin(); it != listFileIndexCache.end(); ++it) {
+        if ((*it)->path == path) {
+            if ((*it)->size == size && (*it)->mtime == mtime) {
+                std::rotate(listFileIndexCache.begin(), it, it + 1);
+                return listFileIndexCache.front();
+            }
+            listFileIndexCache.erase(it);  // stale
+            break;
+        }
+    }
+
+    auto index = buildListFileIndex(path, size, mtime);
+    if (!index)
+        return nullptr;
+
+    listFileIndexCache.insert(listFileIndexCache.begin(), index);
+    const size_t limit = ult::limitedMemory ? 1 : LIST_FILE_INDEX_CACHE_LIMIT;
+    if (listFileIndexCache.size() > limit)
+        listFileIndexCache.resize(limit);
+    return index;
+}
+
+void clearListFileIndexCache() {
+    std::lock_guard<std::mutex> lock(listFileIndexMutex);
+    listFileIndexCache.clear();
+}
+
+/**
+ * @brief Indexed replacement for getEntryFromListFile().
+ *
+ * @return The line without its line ending, or an empty string if the index is out of range.
+ */
+std::string getCachedListFileEntry(const std::string& listPath, size_t entryIndex) {
+    const auto index = getListFileIndex(listPath);
+    if (!index || entryIndex >= index->lineOffsets.size())
+        return "";
+
+    const u32 start = index->lineOffsets[entryIndex];
+    const u32 end = (entryIndex + 1 < index->lineOffsets.size()) ? index->lineOffsets[entryIndex + 1] : static_cast<u32>(index->size);
+
+    FILE* file = fopen(listPath.c_str(), "rb");
+    if (!file)
+        return "";
+
+    std::string line(end - start, '\0');
+    const bool ok = fseek(file, start, SEEK_SET) == 0 && fread(line.data(), 1, line.size(), file) == line.size();
+    fclose(file);
+    if (!ok)
+        return "";
+
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+        line.pop_back();
+    return line;
+}
+
+/**
+ * @brief Streams the non-empty lines of a list file without loading the whole list.
+ *
+ * @param maxItems Stop after this many lines (0 = no limit).
+ * @param callback Called with each line (line ending stripped); return false to stop early.
+ * @return The number of lines passed to the callback.
+ */
+template<typename Callback>
+size_t forEachListFileLine(const std::string& listPath, size_t maxItems, Callback&& callback) {
+    FILE* file = fopen(listPath.c_str(), "r");
+    if (!file)
+        return 0;
+
+    static constexpr size_t BUFFER_SIZE = 8192;
+    char buffer[BUFFER_SIZE];
+    std::string line;
+    size_t count = 0;
+    bool inLine = false;
+
+    while (fgets(buffer, BUFFER_SIZE, file)) {
+        if (!inLine)
+            line.clear();
+        line += buffer;
+
+        // Long lines arrive in several fgets calls
+        inLine = line.back() != '\n' && !feof(file);
+        if (inLine)
+            continue;
+
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        if (line.empty())
+            continue;
 
-    std::string fileName = getNameFromPath(entry);
-    if (!isDirectory(entry)) {
-        dropExtension(fileName);
+        ++count;
+        if (!callback(line) || (maxItems && count >= maxItems))
+            break;
     }
+    fclose(file);
+    return count;
+}
 
-    std::vector<std::string> modifiedCmd;
-    std::string commandName;
-    std::string modifiedArg;
-    size_t startPos, endPos;
-    std::string replacement;
+/**
+ * @brief Streams two list files in lockstep, e.g. the -src/-dest lists of cp and mv.
+ *
+ * Lines are paired by position; pairs where either line is empty are skipped, and streaming
+ * stops at the end of the shorter list.
+ *
+ * @param callback Called with each (source line, destination line); return false to stop early.
+ * @return The number of pairs passed to the callback, or 0 if either list cannot be opened.
+ */
+template<typename Callback>
+size_t forEachListFilePair(const std::string& firstListPath, const std::string& secondListPath, Callback&& callback) {
+    FILE* firstFile = fopen(firstListPath.c_str(), "r");
+    FILE* secondFile = fopen(secondListPath.c_str(), "r");
+    if (!firstFile || !secondFile) {
+        if (firstFile) fclose(firstFile);
+        if (secondFile) fclose(secondFile);
+        return 0;
+    }
+
+    static constexpr size_t BUFFER_SIZE = 8192;
+    char buffer[BUFFER_SIZE];
+    std::string first, second;
+    size_t count = 0;
+
+    const auto readLine = [&buffer](FILE* file, std::string& line) {
+        line.clear();
+        while (fgets(buffer, BUFFER_SIZE, file)) {
+            line += buffer;
+            if (line.back() == '\n')
+                break;
+        }
+        if (line.empty())
+            return false;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        return true;
+    };
 
-    std::string path;
-    std::string raw;
+    while (readLine(firstFile, first) && readLine(secondFile, second)) {
+        if (first.empty() || second.empty())
+            continue;
+        ++count;
+        if (!callback(first, second))
+            break;
+    }
 
-    const std::string indexStr = ult::to_string(entryIndex);
+    fclose(firstFile);
+    fclose(secondFile);
+    return count;
+}
+
+
+/**
+ * @brief Source commands compiled once into literal segments and typed holes.
+ *
+ * getSourceReplacement() is called once per selection entry with the same command list, so the
+ * command list is split up front into literal text and {file_source}, {file_name},
+ * {folder_name} and {index} holes. Each entry is then produced by one pass per argument that
+ * fills the holes, reserving the output size first. Arguments using the source placeholders
+ * ({list_source(...)}, {json_file_source(...)}, ...) are resolved after the holes, with the
+ * source list parsed once per template instead of once per argument.
+ */
+struct SourceCommandTemplate {
+    enum SegmentKind : u8 { SEGMENT_LITERAL, SEGMENT_FILE_SOURCE, SEGMENT_FILE_NAME, SEGMENT_FOLDER_NAME, SEGMENT_INDEX };
+    enum SourceFlag : u8 {
+        SOURCE_LIST = 1 << 0,
+        SOURCE_LIST_FILE = 1 << 1,
+        SOURCE_INI_FILE = 1 << 2,
+        SOURCE_JSON = 1 << 3,
+        SOURCE_JSON_FILE = 1 << 4
+    };
+
+    struct Segment {
+        SegmentKind kind;
+        std::string text;  // literal text (SEGMENT_LITERAL only)
+    };
+    struct Arg {
+        std::vector<Segment> segments;
+        u8 sources = 0;  // source placeholders used by this argument
+    };
+    struct Command {
+        std::vector<Arg> args;
+        u8 knownSources = 0;  // sources declared up to and including this command
+    };
+
+    std::vector<std::vector<std::string>> source;  // the uncompiled commands (cache key)
+    std::string packagePath;
+
+    std::vector<Command> commands;
+    std::vector<std::string> listItems;
+    std::string listPath, iniPath, jsonString, jsonPath;
+    bool usesFileName = false;
+    bool usesFolderName = false;
+    bool usingFileSource = false;
+    bool hasDownload = false;
+};
+
+static std::shared_ptr<const SourceCommandTemplate> compileSourceCommands(const std::vector<std::vector<std::string>>& commands,
+                                                                          const std::string& packagePath) {
+    static constexpr std::pair<std::string_view, SourceCommandTemplate::SegmentKind> holeTokens[] = {
+        {"{file_source}", SourceCommandTemplate::SEGMENT_FILE_SOURCE},
+        {"{file_name}", SourceCommandTemplate::SEGMENT_FILE_NAME},
+        {"{folder_name}", SourceCommandTemplate::SEGMENT_FOLDER_NAME},
+        {"{index}", SourceCommandTemplate::SEGMENT_INDEX}
+    };
+    static constexpr std::pair<std::string_view, u8> sourceOpeners[] = {
+        {"{list_source(", SourceCommandTemplate::SOURCE_LIST},
+        {"{list_file_source(", SourceCommandTemplate::SOURCE_LIST_FILE},
+        {"{ini_file_source(", SourceCommandTemplate::SOURCE_INI_FILE},
+        {"{json_source(", SourceCommandTemplate::SOURCE_JSON},
+        {"{json_file_source(", SourceCommandTemplate::SOURCE_JSON_FILE}
+    };
+
+    auto compiled = std::make_shared<SourceCommandTemplate>();
+    compiled->source = commands;
+    compiled->packagePath = packagePath;
+    compiled->commands.reserve(commands.size());
+
+    bool inEristaSection = false;
+    bool inMarikoSection = false;
+    u8 knownSources = 0;
+    std::string listString;
 
     for (const auto& cmd : commands) {
         if (cmd.empty()) {
             continue;
         }
 
-        modifiedCmd.clear();
-        commandName = cmd[0];
-
+        const std::string& commandName = cmd[0];
         if (commandName == "download") {
-            isDownloadCommand.store(true, std::memory_order_release);
+            compiled->hasDownload = true;
         }
 
-        if (stringToLowercase(commandName) == "erista:") {
+        const std::string lowerName = stringToLowercase(commandName);
+        if (lowerName == "erista:") {
             inEristaSection = true;
             inMarikoSection = false;
             continue;
-        } else if (stringToLowercase(commandName) == "mariko:") {
+        } else if (lowerName == "mariko:") {
             inEristaSection = false;
             inMarikoSection = true;
             continue;
         }
 
-        if ((inEristaSection && usingErista) ||
-            (inMarikoSection && usingMariko) ||
-            (!inEristaSection && !inMarikoSection))
-        {
-            // Apply placeholder replacements if necessary
-            for (const auto& arg : cmd) {
-                modifiedArg = arg;
+        if ((inEristaSection && !usingErista) || (inMarikoSection && !usingMariko)) {
+            continue;
+        }
 
-                if (commandName == "file_source") {
-                    usingFileSource = true;
-                }
-                else if (commandName == "list_source" && listString.empty()) {
-                    listString = cmd[1];
-                    removeQuotes(listString);
-                }
-                else if (commandName == "list_file_source" && listPath.empty()) {
-                    listPath = cmd[1];
-                    preprocessPath(listPath, packagePath);
-                }
-                else if (commandName == "ini_file_source" && iniPath.empty()) {
-                    iniPath = cmd[1];
-                    preprocessPath(iniPath, packagePath);
-                }
-                else if (commandName == "json_source" && jsonString.empty()) {
-                    jsonString = cmd[1];
-                }
-                else if (commandName == "json_file_source" && jsonPath.empty()) {
-                    jsonPath = cmd[1];
-                    preprocessPath(jsonPath, packagePath);
-                }
+        // Source declarations take effect from the command that declares them
+        if (commandName == "file_source") {
+            compiled->usingFileSource = true;
+        } else if (cmd.size() > 1) {
+            if (commandName == "list_source" && !(knownSources & SourceCommandTemplate::SOURCE_LIST)) {
+                listString = cmd[1];
+                removeQuotes(listString);
+                knownSources |= SourceCommandTemplate::SOURCE_LIST;
+            } else if (commandName == "list_file_source" && !(knownSources & SourceCommandTemplate::SOURCE_LIST_FILE)) {
+                compiled->listPath = cmd[1];
+                preprocessPath(compiled->listPath, packagePath);
+                knownSources |= SourceCommandTemplate::SOURCE_LIST_FILE;
+            } else if (commandName == "ini_file_source" && !(knownSources & SourceCommandTemplate::SOURCE_INI_FILE)) {
+                compiled->iniPath = cmd[1];
+                preprocessPath(compiled->iniPath, packagePath);
+                knownSources |= SourceCommandTemplate::SOURCE_INI_FILE;
+            } else if (commandName == "json_source" && !(knownSources & SourceCommandTemplate::SOURCE_JSON)) {
+                compiled->jsonString = cmd[1];
+                knownSources |= SourceCommandTemplate::SOURCE_JSON;
+            } else if (commandName == "json_file_source" && !(knownSources & SourceCommandTemplate::SOURCE_JSON_FILE)) {
+                compiled->jsonPath = cmd[1];
+                preprocessPath(compiled->jsonPath, packagePath);
+                knownSources |= SourceCommandTemplate::SOURCE_JSON_FILE;
+            }
+        }
 
-                // These three always apply
-                replaceAllPlaceholders(modifiedArg, "{file_source}", entry);
-                replaceAllPlaceholders(modifiedArg, "{file_name}", fileName);
-                path = getParentDirNameFromPath(entry);
-                removeQuotes(path);
-                replaceAllPlaceholders(modifiedArg, "{folder_name}", path);
-                replaceAllPlaceholders(modifiedArg, "{index}", indexStr);
-
-                // {list_source(...)} block
-                if (modifiedArg.find("{list_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{list_source(");
-                    endPos   = modifiedArg.find(")}", startPos + 13);  // Find )}  after the opening
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        const auto& listItems = stringToList(listString);
-                        raw = (entryIndex < listItems.size()) ? listItems[entryIndex] : "";
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
-                }
+        SourceCommandTemplate::Command& command = compiled->commands.emplace_back();
+        command.knownSources = knownSources;
+        command.args.reserve(cmd.size());
 
-                // {list_file_source(...)} block
-                if (modifiedArg.find("{list_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{list_file_source(");
-                    // Find the closing )}  AFTER the opening we just found
-                    endPos = modifiedArg.find(")}", startPos + 18);  // 18 = length of "{list_file_source("
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = getEntryFromListFile(listPath, entryIndex);
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+        for (const auto& arg : cmd) {
+            SourceCommandTemplate::Arg& compiledArg = command.args.emplace_back();
+            size_t literalStart = 0;
+            size_t pos = arg.find('{');
+
+            while (pos != std::string::npos) {
+                size_t tokenLen = 0;
+                for (const auto& [token, kind] : holeTokens) {
+                    if (arg.compare(pos, token.size(), token) == 0) {
+                        if (pos > literalStart)
+                            compiledArg.segments.push_back({SourceCommandTemplate::SEGMENT_LITERAL, arg.substr(literalStart, pos - literalStart)});
+                        compiledArg.segments.push_back({kind, std::string()});
+                        compiled->usesFileName |= (kind == SourceCommandTemplate::SEGMENT_FILE_NAME);
+                        compiled->usesFolderName |= (kind == SourceCommandTemplate::SEGMENT_FOLDER_NAME);
+                        tokenLen = token.size();
+                        break;
                     }
                 }
-
-                // {ini_file_source(...)} block - FIXED
-                if (modifiedArg.find("{ini_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    // applyReplaceIniPlaceholder modifies modifiedArg in place, so we just call it
-                    applyReplaceIniPlaceholder(modifiedArg, "ini_file_source", iniPath);
-                    // No additional replacement needed!
-                }
-
-                // {json_source(...)} block
-                if (modifiedArg.find("{json_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{json_source(");
-                    endPos   = modifiedArg.find(")}", startPos + 13);  // Find )}  after the opening
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = replaceJsonPlaceholder(
-                            modifiedArg.substr(startPos, endPos - startPos + 2),
-                            "json_source",
-                            jsonString
-                        );
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
+                if (tokenLen) {
+                    literalStart = pos + tokenLen;
+                    pos = arg.find('{', literalStart);
+                    continue;
                 }
-
-
-                // {json_file_source(...)} block
-                if (modifiedArg.find("{json_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{json_file_source(");
-                    endPos   = modifiedArg.find(")}", startPos + 18);  // Find )}  after the opening
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = replaceJsonPlaceholder(
-                            modifiedArg.substr(startPos, endPos - startPos + 2),
-                            "json_file_source",
-                            jsonPath
-                        );
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+                for (const auto& [opener, flag] : sourceOpeners) {
+                    if (arg.compare(pos, opener.size(), opener) == 0) {
+                        compiledArg.sources |= flag;
+                        break;
                     }
                 }
-
-                modifiedCmd.push_back(std::move(modifiedArg));
+                pos = arg.find('{', pos + 1);
             }
-
-            modifiedCommands.emplace_back(std::move(modifiedCmd));
+            if (literalStart < arg.size() || compiledArg.segments.empty())
+                compiledArg.segments.push_back({SourceCommandTemplate::SEGMENT_LITERAL, arg.substr(literalStart)});
         }
     }
 
-    if (usingFileSource) {
-        modifiedCommands.insert(modifiedCommands.begin(), { "file_name", fileName });
-        modifiedCommands.insert(modifiedCommands.begin(), { "folder_name", path });
-        modifiedCommands.insert(modifiedCommands.begin(), { "sourced_path", entry });
+    if (compiled->usingFileSource) {
+        compiled->usesFileName = true;
+        compiled->usesFolderName = true;
+    }
+    if (!listString.empty())
+        compiled->listItems = stringToList(listString);
+
+    return compiled;
+}
+
+// Replaces the first "{opener...)}" in arg, after the first '*' has been replaced by the entry index
+template<typename Resolver>
+static void replaceSourcePlaceholder(std::string& arg, std::string_view opener, const std::string& indexStr, Resolver&& resolve) {
+    applyPlaceholderReplacement(arg, "*", indexStr);
+    const size_t startPos = arg.find(opener);
+    if (startPos == std::string::npos)
+        return;
+    const size_t endPos = arg.find(")}", startPos + opener.size());
+    if (endPos == std::string::npos)
+        return;
+    arg.replace(startPos, endPos - startPos + 2, returnOrNull(resolve(arg.substr(startPos, endPos - startPos + 2))));
+}
+
+static std::vector<std::vector<std::string>> expandSourceCommands(const SourceCommandTemplate& compiled,
+                                                                  const std::string& entry, size_t entryIndex) {
+    if (compiled.hasDownload) {
+        isDownloadCommand.store(true, std::memory_order_release);
+    }
+
+    // Per-entry values are only computed when the template uses them
+    std::string fileName, folderName;
+    if (compiled.usesFileName) {
+        fileName = getNameFromPath(entry);
+        if (!isDirectory(entry)) {
+            dropExtension(fileName);
+        }
+    }
+    if (compiled.usesFolderName) {
+        folderName = getParentDirNameFromPath(entry);
+        removeQuotes(folderName);
+    }
+    const std::string indexStr = ult::to_string(entryIndex);
+    static const std::string emptySource;
+
+    std::vector<std::vector<std::string>> modifiedCommands;
+    modifiedCommands.reserve(compiled.commands.size() + (compiled.usingFileSource ? 3 : 0));
+
+    if (compiled.usingFileSource) {
+        modifiedCommands.push_back({ "sourced_path", entry });
+        modifiedCommands.push_back({ "folder_name", folderName });
+        modifiedCommands.push_back({ "file_name", fileName });
+    }
+
+    for (const auto& command : compiled.commands) {
+        std::vector<std::string>& modifiedCmd = modifiedCommands.emplace_back();
+        modifiedCmd.reserve(command.args.size());
+
+        for (const auto& arg : command.args) {
+            const std::string* values[] = {nullptr, &entry, &fileName, &folderName, &indexStr};
+
+            size_t length = 0;
+            for (const auto& segment : arg.segments)
+                length += (segment.kind == SourceCommandTemplate::SEGMENT_LITERAL) ? segment.text.size() : values[segment.kind]->size();
+
+            std::string& modifiedArg = modifiedCmd.emplace_back();
+            modifiedArg.reserve(length);
+            for (const auto& segment : arg.segments)
+                modifiedArg += (segment.kind == SourceCommandTemplate::SEGMENT_LITERAL) ? segment.text : *values[segment.kind];
+
+            if (!arg.sources)
+                continue;
+
+            const u8 known = command.knownSources;
+            if (arg.sources & SourceCommandTemplate::SOURCE_LIST) {
+                replaceSourcePlaceholder(modifiedArg, "{list_source(", indexStr, [&](const std::string&) {
+                    return (known & SourceCommandTemplate::SOURCE_LIST) && entryIndex < compiled.listItems.size()
+                        ? compiled.listItems[entryIndex] : std::string();
+                });
+            }
+            if (arg.sources & SourceCommandTemplate::SOURCE_LIST_FILE) {
+                replaceSourcePlaceholder(modifiedArg, "{list_file_source(", indexStr, [&](const std::string&) {
+                    return getCachedListFileEntry((known & SourceCommandTemplate::SOURCE_LIST_FILE) ? compiled.listPath : emptySource, entryIndex);
+                });
+            }
+            if (arg.sources & SourceCommandTemplate::SOURCE_INI_FILE) {
+                applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                applyReplaceIniPlaceholder(modifiedArg, "ini_file_source", (known & SourceCommandTemplate::SOURCE_INI_FILE) ? compiled.iniPath : emptySource);
+            }
+            if (arg.sources & SourceCommandTemplate::SOURCE_JSON) {
+                replaceSourcePlaceholder(modifiedArg, "{json_source(", indexStr, [&](const std::string& placeholder) {
+                    return replaceJsonPlaceholder(placeholder, "json_source", (known & SourceCommandTemplate::SOURCE_JSON) ? compiled.jsonString : emptySource);
+                });
+            }
+            if (arg.sources & SourceCommandTemplate::SOURCE_JSON_FILE) {
+                replaceSourcePlaceholder(modifiedArg, "{json_file_source(", indexStr, [&](const std::string& placeholder) {
+                    return replaceJsonPlaceholder(placeholder, "json_file_source", (known & SourceCommandTemplate::SOURCE_JSON_FILE) ? compiled.jsonPath : emptySource);
+                });
+            }
+        }
     }
 
     return modifiedCommands;
 }
 
+static constexpr size_t SOURCE_TEMPLATE_CACHE_LIMIT = 4;
+static std::vector<std::shared_ptr<const SourceCommandTemplate>> sourceTemplateCache;  // most recently used first
+static std::mutex sourceTemplateMutex;
+
+/**
+ * @brief Applies the per-entry source placeholders to a command list.
+ *
+ * The compiled template for the command list is cached, so repeated calls for the entries of
+ * one selection menu only fill holes.
+ */
+std::vector<std::vector<std::string>> getSourceReplacement(const std::vector<std::vector<std::string>>& commands,
+    const std::string& entry, size_t entryIndex, const std::string& packagePath = "") {
+
+    std::shared_ptr<const SourceCommandTemplate> compiled;
+    {
+        std::lock_guard<std::mutex> lock(sourceTemplateMutex);
+        for (auto it = sourceTemplateCache.begin(); it != sourceTemplateCache.end(); ++it) {
+            if ((*it)->packagePath == packagePath && (*it)->source == commands) {
+                std::rotate(sourceTemplateCache.begin(), it, it + 1);
+                compiled = sourceTemplateCache.front();
+                break;
+            }
+        }
+    }
+
+    if (!compiled) {
+        compiled = compileSourceCommands(commands, packagePath);
+
+        std::lock_guard<std::mutex> lock(sourceTemplateMutex);
+        sourceTemplateCache.insert(sourceTemplateCache.begin(), compiled);
+        const size_t limit = ult::limitedMemory ? 1 : SOURCE_TEMPLATE_CACHE_LIMIT;
+        if (sourceTemplateCache.size() > limit)
+            sourceTemplateCache.resize(limit);
+    }
+
+    return expandSourceCommands(*compiled, entry, entryIndex);
+}
+
 
 std::string getCurrentTimestamp(const std::string& format) {
     // Try using standard POSIX time() function
@@ -2621,180 +3331,460 @@ std::string getCurrentTimestamp(const std::string& format) {
 
 
 
-// Helper function to skip spaces
-void skipSpaces(const std::string& expression, size_t& pos) {
-    while (pos < expression.length() && std::isspace(expression[pos])) {
-        ++pos;
+/**
+ * @brief Compiled {math(...)} expressions.
+ *
+ * Expressions are compiled by a Pratt parser into a small stack bytecode and cached by their
+ * source text, so trackbars that re-evaluate the same expression every tick only run bytecode.
+ *
+ * Supported syntax, from lowest to highest precedence:
+ *   |   ^   &   << >>   + -   * / %   unary - + ~
+ * plus parentheses and the functions min(a, b, ...), max(a, b, ...) and clamp(x, lo, hi).
+ * Integer literals (decimal or 0x hex) stay 64-bit integers; literals with a '.' are doubles.
+ * Division of integers stays integral when exact, so 7/2 still yields 3.50. Bit operations,
+ * shifts and % require integral operands.
+ */
+struct MathValue {
+    s64 i = 0;
+    double f = 0.0;
+    bool isInt = true;
+};
+
+enum class MathOp : u8 {
+    Push, Neg, BitNot,
+    Add, Sub, Mul, Div, Mod,
+    Shl, Shr, And, Xor, Or,
+    Min, Max, Clamp
+};
+
+struct MathInstruction {
+    MathOp op;
+    MathValue value;  // Push only
+};
+
+struct CompiledMathExpression {
+    std::string source;
+    std::vector<MathInstruction> code;
+    bool valid = false;
+};
+
+static constexpr size_t MATH_STACK_LIMIT = 32;
+static constexpr size_t MATH_NESTING_LIMIT = 32;  // parentheses, unary operators and function calls
+static constexpr size_t MATH_CACHE_LIMIT = 16;
+
+class MathCompiler {
+public:
+    MathCompiler(const std::string& source, std::vector<MathInstruction>& code) : src(source), code(code) {}
+
+    bool compile() {
+        parse(0);
+        skipSpaces();
+        return ok && pos == src.size();
+    }
+
+private:
+    const std::string& src;
+    std::vector<MathInstruction>& code;
+    size_t pos = 0;
+    size_t depth = 0;    // values on the evaluation stack
+    size_t nesting = 0;  // recursion depth of parsePrefix(), bounded to protect the thread stack
+    bool ok = true;
+
+    void skipSpaces() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos])))
+            ++pos;
     }
-}
 
-// Helper function to parse a number or a nested expression in parentheses
-double parseExpression(const std::string& expression, size_t& pos, bool& valid);
+    bool accept(char c) {
+        skipSpaces();
+        if (pos < src.size() && src[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
 
-double parseNumber(const std::string& expression, size_t& pos, bool& valid) {
-    skipSpaces(expression, pos);
+    void emit(MathOp op, size_t popped, const MathValue& value = MathValue()) {
+        code.push_back({op, value});
+        depth = depth - popped + 1;
+        if (depth > MATH_STACK_LIMIT)
+            ok = false;
+    }
 
-    // Check if the expression starts with a '(' indicating a nested expression
-    if (expression[pos] == '(') {
-        ++pos;  // Skip the '('
-        const double result = parseExpression(expression, pos, valid);
-        if (expression[pos] == ')') {
-            ++pos;  // Skip the ')'
-        } else {
-            valid = false;  // Unmatched parentheses
+    // Binding powers (left, right) of the infix operator at pos; returns false if there is none
+    bool peekInfix(MathOp& op, u8& leftBp, u8& rightBp, size_t& length) const {
+        if (pos >= src.size())
+            return false;
+        length = 1;
+        switch (src[pos]) {
+            case '|': op = MathOp::Or;  leftBp = 1;  break;
+            case '^': op = MathOp::Xor; leftBp = 3;  break;
+            case '&': op = MathOp::And; leftBp = 5;  break;
+            case '<':
+            case '>':
+                if (pos + 1 >= src.size() || src[pos + 1] != src[pos])
+                    return false;
+                op = (src[pos] == '<') ? MathOp::Shl : MathOp::Shr;
+                leftBp = 7;
+                length = 2;
+                break;
+            case '+': op = MathOp::Add; leftBp = 9;  break;
+            case '-': op = MathOp::Sub; leftBp = 9;  break;
+            case '*': op = MathOp::Mul; leftBp = 11; break;
+            case '/': op = MathOp::Div; leftBp = 11; break;
+            case '%': op = MathOp::Mod; leftBp = 11; break;
+            default:
+                return false;
         }
-        return result;
+        rightBp = leftBp + 1;
+        return true;
     }
 
-    // Parse a number
-    double result = 0.0f;
-    bool hasDecimal = false;
-    double decimalPlace = 0.1f;
-    bool isNegative = false;
+    void parse(u8 minBp) {
+        parsePrefix();
 
-    if (expression[pos] == '-') {
-        isNegative = true;
-        ++pos;
+        MathOp op;
+        u8 leftBp, rightBp;
+        size_t length;
+        while (ok) {
+            skipSpaces();
+            if (!peekInfix(op, leftBp, rightBp, length) || leftBp < minBp)
+                break;
+            pos += length;
+            parse(rightBp);
+            emit(op, 2);
+        }
     }
 
-    while (pos < expression.length() && (std::isdigit(expression[pos]) || expression[pos] == '.')) {
-        if (expression[pos] == '.') {
-            hasDecimal = true;
+    void parsePrefix() {
+        static constexpr u8 UNARY_BP = 13;
+
+        skipSpaces();
+        if (!ok || pos >= src.size() || nesting >= MATH_NESTING_LIMIT) {
+            ok = false;
+            return;
+        }
+        struct NestingGuard {
+            size_t& nesting;
+            explicit NestingGuard(size_t& n) : nesting(n) { ++nesting; }
+            ~NestingGuard() { --nesting; }
+        } nestingGuard(nesting);
+
+        const char c = src[pos];
+        if (c == '(') {
             ++pos;
-            continue;
+            parse(0);
+            if (!accept(')'))
+                ok = false;
+        } else if (c == '-' || c == '+' || c == '~') {
+            ++pos;
+            parse(UNARY_BP);
+            if (c == '-')
+                emit(MathOp::Neg, 1);
+            else if (c == '~')
+                emit(MathOp::BitNot, 1);
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            parseNumber();
+        } else if (std::isalpha(static_cast<unsigned char>(c))) {
+            parseFunction();
+        } else {
+            ok = false;
+        }
+    }
+
+    void parseNumber() {
+        MathValue value;
+        const char* start = src.c_str() + pos;
+        char* end = nullptr;
+
+        if (src.compare(pos, 2, "0x") == 0 || src.compare(pos, 2, "0X") == 0) {
+            value.i = static_cast<s64>(std::strtoull(start + 2, &end, 16));
+            if (end == start + 2)
+                ok = false;
+        } else {
+            size_t digitsEnd = pos;
+            while (digitsEnd < src.size() && (std::isdigit(static_cast<unsigned char>(src[digitsEnd])) || src[digitsEnd] == '.'))
+                ++digitsEnd;
+
+            if (src.find('.', pos) < digitsEnd) {
+                value.isInt = false;
+                value.f = std::strtod(start, &end);
+            } else {
+                errno = 0;
+                value.i = std::strtoll(start, &end, 10);
+                if (errno == ERANGE) {
+                    value.isInt = false;
+                    value.f = std::strtod(start, &end);
+                }
+            }
+            if (end == start)
+                ok = false;
         }
 
-        if (hasDecimal) {
-            result += (expression[pos] - '0') * decimalPlace;
-            decimalPlace *= 0.1f;
+        pos = end ? static_cast<size_t>(end - src.c_str()) : pos + 1;
+        emit(MathOp::Push, 0, value);
+    }
+
+    void parseFunction() {
+        const size_t nameStart = pos;
+        while (pos < src.size() && std::isalpha(static_cast<unsigned char>(src[pos])))
+            ++pos;
+        const std::string_view name(src.data() + nameStart, pos - nameStart);
+
+        MathOp op;
+        size_t minArgs, maxArgs;
+        if (name == "min" || name == "max") {
+            op = (name == "min") ? MathOp::Min : MathOp::Max;
+            minArgs = 2;
+            maxArgs = SIZE_MAX;
+        } else if (name == "clamp") {
+            op = MathOp::Clamp;
+            minArgs = maxArgs = 3;
         } else {
-            result = result * 10.0f + (expression[pos] - '0');
+            ok = false;
+            return;
+        }
+
+        if (!accept('(')) {
+            ok = false;
+            return;
         }
-        ++pos;
+
+        size_t args = 0;
+        do {
+            parse(0);
+            ++args;
+            // min/max fold pairwise as the arguments arrive
+            if (op != MathOp::Clamp && args > 1)
+                emit(op, 2);
+        } while (ok && accept(','));
+
+        if (!accept(')') || args < minArgs || args > maxArgs) {
+            ok = false;
+            return;
+        }
+        if (op == MathOp::Clamp)
+            emit(op, 3);
     }
+};
 
-    if (isNegative) {
-        result = -result;
+static bool mathToInteger(const MathValue& value, s64& out) {
+    if (value.isInt) {
+        out = value.i;
+        return true;
     }
+    if (value.f != std::trunc(value.f) || value.f < -9.2e18 || value.f > 9.2e18)
+        return false;
+    out = static_cast<s64>(value.f);
+    return true;
+}
 
-    valid = true;
-    return result;
+static inline double mathToDouble(const MathValue& value) {
+    return value.isInt ? static_cast<double>(value.i) : value.f;
 }
 
-// Function to evaluate an expression, which may include parentheses
-double parseExpression(const std::string& expression, size_t& pos, bool& valid) {
-    skipSpaces(expression, pos);
+static inline MathValue mathInt(s64 i) {
+    MathValue value;
+    value.i = i;
+    return value;
+}
+
+static inline MathValue mathFloat(double f) {
+    MathValue value;
+    value.f = f;
+    value.isInt = false;
+    return value;
+}
 
-    double result = parseNumber(expression, pos, valid);
-    if (!valid) return 0;
+static inline bool mathLess(const MathValue& a, const MathValue& b) {
+    return (a.isInt && b.isInt) ? a.i < b.i : mathToDouble(a) < mathToDouble(b);
+}
 
-    char op;
-    double operand;
-    while (pos < expression.length()) {
-        skipSpaces(expression, pos);
-        if (pos >= expression.length()) break;
+static bool runMathExpression(const CompiledMathExpression& expression, MathValue& result) {
+    MathValue stack[MATH_STACK_LIMIT];
+    size_t sp = 0;
+    s64 x, y;
 
-        op = expression[pos++];
-        skipSpaces(expression, pos);
+    for (const MathInstruction& instruction : expression.code) {
+        switch (instruction.op) {
+            case MathOp::Push:
+                stack[sp++] = instruction.value;
+                continue;
+            case MathOp::Neg: {
+                MathValue& a = stack[sp - 1];
+                a = a.isInt ? mathInt(static_cast<s64>(0 - static_cast<u64>(a.i))) : mathFloat(-a.f);
+                continue;
+            }
+            case MathOp::BitNot:
+                if (!mathToInteger(stack[sp - 1], x))
+                    return false;
+                stack[sp - 1] = mathInt(~x);
+                continue;
+            case MathOp::Clamp: {
+                sp -= 2;
+                MathValue& value = stack[sp - 1];
+                if (mathLess(value, stack[sp]))
+                    value = stack[sp];
+                if (mathLess(stack[sp + 1], value))
+                    value = stack[sp + 1];
+                continue;
+            }
+            default:
+                break;
+        }
 
-        operand = parseNumber(expression, pos, valid);
-        if (!valid) return 0;
+        // Binary operators
+        --sp;
+        MathValue& a = stack[sp - 1];
+        const MathValue& b = stack[sp];
+        const bool integral = a.isInt && b.isInt;
 
-        switch (op) {
-            case '+':
-                result += operand;
+        switch (instruction.op) {
+            case MathOp::Add:
+                a = integral ? mathInt(static_cast<s64>(static_cast<u64>(a.i) + static_cast<u64>(b.i))) : mathFloat(mathToDouble(a) + mathToDouble(b));
                 break;
-            case '-':
-                result -= operand;
+            case MathOp::Sub:
+                a = integral ? mathInt(static_cast<s64>(static_cast<u64>(a.i) - static_cast<u64>(b.i))) : mathFloat(mathToDouble(a) - mathToDouble(b));
                 break;
-            case '*':
-                result *= operand;
+            case MathOp::Mul:
+                a = integral ? mathInt(static_cast<s64>(static_cast<u64>(a.i) * static_cast<u64>(b.i))) : mathFloat(mathToDouble(a) * mathToDouble(b));
                 break;
-            case '/':
-                if (operand == 0) {
-                    valid = false;  // Division by zero
-                    return 0;
-                }
-                result /= operand;
+            case MathOp::Div:
+                if (mathToDouble(b) == 0)
+                    return false;  // Division by zero
+                if (integral && b.i != -1 && a.i % b.i == 0)
+                    a = mathInt(a.i / b.i);
+                else
+                    a = mathFloat(mathToDouble(a) / mathToDouble(b));
                 break;
-            case '%':
-                if (result != static_cast<double>(static_cast<int>(result)) ||
-                    operand != static_cast<double>(static_cast<int>(operand))) {
-                    valid = false;  // Modulus only valid for integers
-                    return 0;
-                }
-                result = static_cast<int>(result) % static_cast<int>(operand);
+            case MathOp::Mod:
+                if (!mathToInteger(a, x) || !mathToInteger(b, y) || y == 0)
+                    return false;  // Modulus only valid for non-zero integers
+                a = mathInt(y == -1 ? 0 : x % y);
+                break;
+            case MathOp::Shl:
+            case MathOp::Shr:
+                if (!mathToInteger(a, x) || !mathToInteger(b, y) || y < 0 || y > 63)
+                    return false;
+                a = mathInt(instruction.op == MathOp::Shl ? static_cast<s64>(static_cast<u64>(x) << y) : (x >> y));
+                break;
+            case MathOp::And:
+            case MathOp::Xor:
+            case MathOp::Or:
+                if (!mathToInteger(a, x) || !mathToInteger(b, y))
+                    return false;
+                a = mathInt(instruction.op == MathOp::And ? (x & y) : instruction.op == MathOp::Xor ? (x ^ y) : (x | y));
+                break;
+            case MathOp::Min:
+                if (mathLess(b, a))
+                    a = b;
+                break;
+            case MathOp::Max:
+                if (mathLess(a, b))
+                    a = b;
                 break;
             default:
-                valid = false;
-                return 0;
+                return false;
         }
     }
 
-    valid = true;
-    return result;
+    if (sp != 1)
+        return false;
+    result = stack[0];
+    return true;
 }
 
-// Function to evaluate a complete expression (this will call parseExpression)
-double evaluateExpression(const std::string& expression, bool& valid) {
-    size_t pos = 0;
-    return parseExpression(expression, pos, valid);
+static std::vector<std::shared_ptr<const CompiledMathExpression>> mathExpressionCache;  // most recently used first
+static std::mutex mathExpressionMutex;
+
+static std::shared_ptr<const CompiledMathExpression> getCompiledMathExpression(const std::string& source) {
+    std::lock_guard<std::mutex> lock(mathExpressionMutex);
+    for (auto it = mathExpressionCache.begin(); it != mathExpressionCache.end(); ++it) {
+        if ((*it)->source == source) {
+            std::rotate(mathExpressionCache.begin(), it, it + 1);
+            return mathExpressionCache.front();
+        }
+    }
+
+    // Invalid expressions are cached too, so they fail fast on every tick
+    auto expression = std::make_shared<CompiledMathExpression>();
+    expression->source = source;
+    expression->valid = MathCompiler(source, expression->code).compile();
+    if (!expression->valid)
+        expression->code.clear();
+
+    mathExpressionCache.insert(mathExpressionCache.begin(), expression);
+    const size_t limit = ult::limitedMemory ? MATH_CACHE_LIMIT / 4 : MATH_CACHE_LIMIT;
+    if (mathExpressionCache.size() > limit)
+        mathExpressionCache.resize(limit);
+    return expression;
 }
 
 // Handle Math Placeholder with Parentheses, Modulus, and Optional Integer Support
 std::string handleMath(const std::string& placeholder) {
-    const size_t startPos = placeholder.find('(') + 1;
-    const size_t endPos = placeholder.find(')');
+    const size_t startPos = placeholder.find('(');
+    const size_t endPos = placeholder.rfind(')');
 
-    if (startPos == std::string::npos || endPos == std::string::npos || startPos >= endPos) {
+    if (startPos == std::string::npos || endPos == std::string::npos || startPos + 1 >= endPos) {
         return NULL_STR;
     }
 
-    std::string mathExpression = placeholder.substr(startPos, endPos - startPos);
+    std::string mathExpression = placeholder.substr(startPos + 1, endPos - startPos - 1);
     removeQuotes(mathExpression);
 
-    const size_t commaPos = mathExpression.find(',');
+    // The optional integer flag follows the first comma outside of parentheses
     bool forceInteger = false;
-
-    if (commaPos != std::string::npos) {
-        std::string secondParam = mathExpression.substr(commaPos + 1);
-        trim(secondParam);
-        forceInteger = (secondParam == TRUE_STR);
-        mathExpression = mathExpression.substr(0, commaPos);
-    }
-
-    size_t pos;
-    // Add spaces around operators to ensure proper parsing
-    for (const char op : {'+', '-', '*', '/'}) {
-        pos = 0;
-        while ((pos = mathExpression.find(op, pos)) != std::string::npos) {
-            if (pos > 0 && mathExpression[pos - 1] != ' ') {
-                mathExpression.insert(pos, " ");
-                pos++;
-            }
-            if (pos + 1 < mathExpression.size() && mathExpression[pos + 1] != ' ') {
-                mathExpression.insert(pos + 1, " ");
-            }
-            pos += 2; // Move past the operator and space
+    int parenDepth = 0;
+    for (size_t i = 0; i < mathExpression.size(); ++i) {
+        const char c = mathExpression[i];
+        if (c == '(') {
+            ++parenDepth;
+        } else if (c == ')') {
+            --parenDepth;
+        } else if (c == ',' && parenDepth == 0) {
+            std::string secondParam = mathExpression.substr(i + 1);
+            trim(secondParam);
+            forceInteger = (secondParam == TRUE_STR);
+            mathExpression.resize(i);
+            break;
         }
     }
 
-    bool valid = false;
-    const double result = evaluateExpression(mathExpression, valid);
+    trim(mathExpression);
+    const auto expression = getCompiledMathExpression(mathExpression);
+    MathValue value;
+    if (!expression->valid || !runMathExpression(*expression, value)) {
+        return NULL_STR;
+    }
 
-    if (!valid) {
+    const double result = value.f;
+    if (!value.isInt && !std::isfinite(result)) {
         return NULL_STR;
     }
 
     // Format the result with StringStream
     StringStream oss;
-    if (forceInteger || result == static_cast<double>(static_cast<int>(result))) {
-        oss << static_cast<int>(result);  // Integer output if required
+    if (value.isInt) {
+        oss << static_cast<long long>(value.i);
+    } else if (forceInteger || result == std::trunc(result)) {
+        // Integer output if required. Casting a double outside the long long range is undefined,
+        // so those (always integral) values are printed from the double itself.
+        if (std::fabs(result) < 9.2e18) {
+            oss << static_cast<long long>(result);
+        } else {
+            char buffer[352];
+            snprintf(buffer, sizeof(buffer), "%.0f", std::trunc(result));
+            oss << buffer;
+        }
     } else {
         // Manually format to two decimal places for double output
-        const int intPart = static_cast<int>(result);
-        const int decimalPart = static_cast<int>((result - intPart) * 100);  // Get two decimal places
+        const double magnitude = std::fabs(result);
+        const long long intPart = static_cast<long long>(magnitude);
+        const int decimalPart = static_cast<int>((magnitude - intPart) * 100);  // Get two decimal places
 
+        if (result < 0) {
+            oss << "-";
+        }
         oss << intPart << ".";
 
         // Handle cases where decimal part has only one digit (e.g., 3.1 should be 3.10)
@@ -2825,82 +3815,357 @@ std::string handleLength(const std::string& placeholder) {
 }
 
 
-// Finds the next occurrence of ANY function-style placeholder opener from `starts`,
-// beginning at `from`. On tie (same index), it prefers the LONGEST token.
-// Returns npos if none found, and sets matchedLen accordingly.
-static size_t findNextOpenToken(const std::string& s,
-                                size_t from,
-                                const std::vector<std::string>& starts,
-                                size_t& matchedLen) {
+/**
+ * @brief In-memory images of files read through {hex_file(pattern, offset, length)}.
+ *
+ * Settings pages read dozens of values from the same binary (e.g. the CUST table of loader.kip),
+ * so the file is read once, the byte offset of each pattern is remembered, and every further
+ * read is served from memory. Images are validated by size and mtime and dropped after any
+ * command that writes files. Other placeholder forms, files over the size limit and
+ * unresolvable reads fall back to replaceHexPlaceholder().
+ *
+ * Reads follow parseHexDataAtCustomOffset() in libultrahand: the pattern is matched as its ASCII
+ * bytes (asciiToHex), its first occurrence is the anchor, the decimal offset is added to the
+ * anchor's byte offset, and length bytes from there are returned as uppercase hex.
+ */
+struct HexFileImage {
+    std::string path;
+    s64 size = 0;
+    s64 mtime = 0;
+    std::vector<u8> data;
+
+    struct Anchor {
+        std::string pattern;
+        size_t offset;  // offset of the pattern's first occurrence
+    };
+    std::vector<Anchor> anchors;
+};
+
+static constexpr size_t HEX_IMAGE_CACHE_LIMIT = 2;
+static constexpr s64 HEX_IMAGE_MAX_SIZE = 2 * 1024 * 1024;
+static constexpr s64 HEX_IMAGE_MAX_SIZE_LIMITED = 256 * 1024;
+static std::vector<std::shared_ptr<HexFileImage>> hexImageCache;  // most recently used first
+static std::mutex hexImageMutex;
+
+void invalidateHexFileImage(const std::string& path) {
+    std::lock_guard<std::mutex> lock(hexImageMutex);
+    hexImageCache.erase(std::remove_if(hexImageCache.begin(), hexImageCache.end(),
+        [&](const std::shared_ptr<HexFileImage>& image) { return image->path == path; }), hexImageCache.end());
+}
+
+void clearHexFileImageCache() {
+    std::lock_guard<std::mutex> lock(hexImageMutex);
+    hexImageCache.clear();
+}
+
+// Must be called with hexImageMutex held
+static HexFileImage* getHexFileImage(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return nullptr;
+    const s64 size = static_cast<s64>(st.st_size);
+    const s64 mtime = static_cast<s64>(st.st_mtime);
+
+    for (auto it = hexImageCache.begin(); it != hexImageCache.end(); ++it) {
+        if ((*it)->path == path) {
+            if ((*it)->size == size && (*it)->mtime == mtime) {
+                std::rotate(hexImageCache.begin(), it, it + 1);
+                return hexImageCache.front().get();
+            }
+            hexImageCache.erase(it);  // stale
+            break;
+        }
+    }
+
+    if (size <= 0 || size > (ult::limitedMemory ? HEX_IMAGE_MAX_SIZE_LIMITED : HEX_IMAGE_MAX_SIZE))
+        return nullptr;
 
-    size_t bestPos = std::string::npos;
-    matchedLen = 0;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return nullptr;
 
-    for (const auto& tok : starts) {
-        const size_t pos = s.find(tok, from);
-        if (pos == std::string::npos) continue;
+    auto image = std::make_shared<HexFileImage>();
+    image->path = path;
+    image->size = size;
+    image->mtime = mtime;
+    image->data.resize(static_cast<size_t>(size));
+    const bool ok = fread(image->data.data(), 1, image->data.size(), file) == image->data.size();
+    fclose(file);
+    if (!ok)
+        return nullptr;
+
+    hexImageCache.insert(hexImageCache.begin(), std::move(image));
+    const size_t limit = ult::limitedMemory ? 1 : HEX_IMAGE_CACHE_LIMIT;
+    if (hexImageCache.size() > limit)
+        hexImageCache.resize(limit);
+    return hexImageCache.front().get();
+}
 
-        if (bestPos == std::string::npos || pos < bestPos ||
-            (pos == bestPos && tok.size() > matchedLen)) {
-            bestPos = pos;
-            matchedLen = tok.size();
+// Reads length bytes at pattern + offset as uppercase hex; returns false if the read cannot be served from memory.
+static bool readHexFileImage(const std::string& path, const std::string& pattern, size_t offset, size_t length,
+                             std::string& out) {
+    std::lock_guard<std::mutex> lock(hexImageMutex);
+    HexFileImage* image = getHexFileImage(path);
+    if (!image)
+        return false;
+
+    const HexFileImage::Anchor* found = nullptr;
+    for (const auto& candidate : image->anchors) {
+        if (candidate.pattern == pattern) {
+            found = &candidate;
+            break;
         }
     }
-    return bestPos;
+    if (!found) {
+        const auto it = std::search(image->data.begin(), image->data.end(), pattern.begin(), pattern.end());
+        if (it == image->data.end())
+            return false;
+        image->anchors.push_back({pattern, static_cast<size_t>(it - image->data.begin())});
+        found = &image->anchors.back();
+    }
+    const size_t anchor = found->offset;
+
+    const size_t start = anchor + offset;
+    if (start < anchor || start > image->data.size() || length > image->data.size() - start)
+        return false;
+
+    static constexpr char hexDigits[] = "0123456789ABCDEF";
+    out.clear();
+    out.reserve(length * 2);
+    for (size_t i = start; i < start + length; ++i) {
+        out += hexDigits[image->data[i] >> 4];
+        out += hexDigits[image->data[i] & 0x0F];
+    }
+    return true;
 }
 
-// Starting at `startPos` which points to the FIRST character of the opener of the
-// CURRENT placeholder (e.g., the '{' in "{slice("), find the matching closing
-// pair for that placeholder. We count nested openers of ANY placeholder type
-// and match on ")}" closes.
-//
-// Return value: index of the ')' in the matching closing ")}" (so you can substr
-// with +2 to include ")}"). Returns npos if unmatched.
-static size_t findMatchingClose(const std::string& s,
-                                size_t startPos,
-                                const std::vector<std::string>& starts,
-                                size_t outerOpenLen) {
+std::string getHexFilePlaceholder(const std::string& placeholder, const std::string& hexPath) {
+    const size_t startPos = placeholder.find('(');
+    const size_t endPos = placeholder.rfind(")}");
+
+    if (!hexPath.empty() && startPos != std::string::npos && endPos != std::string::npos && startPos < endPos) {
+        const std::string content = placeholder.substr(startPos + 1, endPos - startPos - 1);
+        const size_t firstComma = content.find(',');
+        const size_t secondComma = (firstComma == std::string::npos) ? std::string::npos : content.find(',', firstComma + 1);
+
+        if (secondComma != std::string::npos && content.find(',', secondComma + 1) == std::string::npos) {
+            std::string pattern = content.substr(0, firstComma);
+            std::string offsetStr = content.substr(firstComma + 1, secondComma - firstComma - 1);
+            std::string lengthStr = content.substr(secondComma + 1);
+            trim(pattern);
+            removeQuotes(pattern);
+            trim(offsetStr);
+            trim(lengthStr);
+
+            std::string result;
+            if (!pattern.empty() && isValidNumber(offsetStr) && isValidNumber(lengthStr) &&
+                readHexFileImage(hexPath, pattern, ult::stoi(offsetStr), ult::stoi(lengthStr), result)) {
+                return result;
+            }
+        }
+    }
+
+    return replaceHexPlaceholder(placeholder, hexPath);
+}
 
-    // We have already seen one opener at startPos
-    int depth = 1;
-    size_t scan = startPos + outerOpenLen;
 
-    size_t openLen;
-    bool openerFirst;
+/**
+ * @brief Sources a function-style placeholder may read from (set by list/json/ini_file/hex_file commands).
+ */
+struct PlaceholderContext {
+    const std::string& hexPath;
+    const std::string& iniPath;
+    const std::string& listString;
+    const std::string& listPath;
+    const std::string& jsonString;
+    const std::string& jsonPath;
+};
 
-    while (scan < s.size()) {
-        // Find next opener (any) and next closer ")}"
-        const size_t nextCloser = s.find(")}", scan);
+// Entry of the static placeholder dispatch table (see placeholderFunctions)
+struct PlaceholderFunction {
+    std::string_view opener;
+    std::string (*resolve)(const std::string& placeholder, const PlaceholderContext& context);
+};
 
-        openLen = 0;
-        const size_t nextOpener = findNextOpenToken(s, scan, starts, openLen);
+/**
+ * @brief Trie over the function-style placeholder openers ("{math(", "{split(", ...).
+ *
+ * Every opener starts with '{', so matching only starts at '{' characters and walks the trie
+ * for the longest opener at that position. Nodes use first-child/next-sibling links to stay small.
+ */
+class PlaceholderOpenerTrie {
+public:
+    PlaceholderOpenerTrie(const PlaceholderFunction* functions, size_t count) {
+        nodes.emplace_back();
+        for (size_t i = 0; i < count; ++i) {
+            u16 node = 0;
+            for (const char c : functions[i].opener) {
+                node = getOrAddChild(node, c);
+            }
+            nodes[node].opener = static_cast<s16>(i);
+        }
+    }
 
-        // Decide which token comes first
-        if (nextCloser == std::string::npos && nextOpener == std::string::npos) {
-            return std::string::npos; // no more tokens
+    // Returns the index of the longest opener starting at pos (or -1) and sets its length
+    int match(const std::string& s, size_t pos, size_t& matchedLen) const {
+        int best = -1;
+        matchedLen = 0;
+        u16 node = 0;
+        for (size_t i = pos; i < s.size(); ++i) {
+            node = findChild(node, s[i]);
+            if (node == NO_NODE)
+                break;
+            if (nodes[node].opener >= 0) {
+                best = nodes[node].opener;
+                matchedLen = i - pos + 1;
+            }
         }
+        return best;
+    }
 
-        openerFirst = false;
-        if (nextOpener != std::string::npos) {
-            if (nextCloser == std::string::npos) openerFirst = true;
-            else openerFirst = (nextOpener < nextCloser);
+private:
+    static constexpr u16 NO_NODE = 0xFFFF;
+
+    struct Node {
+        u16 firstChild = NO_NODE;
+        u16 nextSibling = NO_NODE;
+        char ch = 0;
+        s16 opener = -1;
+    };
+    std::vector<Node> nodes;
+
+    u16 findChild(u16 node, char c) const {
+        for (u16 child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling) {
+            if (nodes[child].ch == c)
+                return child;
         }
+        return NO_NODE;
+    }
 
-        if (openerFirst) {
-            // Found a nested opener
-            ++depth;
-            scan = nextOpener + openLen; // continue after this opener
-        } else {
-            // Found a closer
-            --depth;
-            if (depth == 0) {
-                return nextCloser; // return index of ')'
+    u16 getOrAddChild(u16 node, char c) {
+        u16 child = findChild(node, c);
+        if (child != NO_NODE)
+            return child;
+        Node added;
+        added.ch = c;
+        added.nextSibling = nodes[node].firstChild;
+        nodes.push_back(added);
+        child = static_cast<u16>(nodes.size() - 1);
+        nodes[node].firstChild = child;
+        return child;
+    }
+};
+
+// Resolution is recursive, so nesting is capped to protect the interpreter's small stack
+static constexpr size_t PLACEHOLDER_MAX_DEPTH = 32;
+// Resolved values that keep producing new placeholders stop after this many rescans
+static constexpr size_t PLACEHOLDER_MAX_PASSES = 16;
+
+// One function-style placeholder found by scanPlaceholderTree()
+struct PlaceholderNode {
+    size_t start;      // index of the opener's '{'
+    size_t close;      // index of the ')' in the matching ")}"
+    u16 opener;        // index into the placeholder list
+    u16 openerLen;
+    std::vector<u32> children;
+};
+
+/**
+ * @brief Finds all openers and ")}" closers in one left-to-right pass and builds the nesting tree.
+ *
+ * Unclosed openers are treated as plain text; placeholders nested inside them move up a level.
+ */
+static void scanPlaceholderTree(const std::string& s, const PlaceholderOpenerTrie& trie,
+                                std::vector<PlaceholderNode>& nodes, std::vector<u32>& roots) {
+    std::vector<u32> open;
+    size_t matchedLen;
+    size_t tooDeep = 0;  // openers past PLACEHOLDER_MAX_DEPTH, kept as plain text
+    const size_t size = s.size();
+
+    for (size_t i = 0; i < size; ) {
+        if (s[i] == '{') {
+            const int opener = trie.match(s, i, matchedLen);
+            if (opener >= 0) {
+                if (open.size() >= PLACEHOLDER_MAX_DEPTH) {
+                    ++tooDeep;
+                } else {
+                    nodes.push_back({i, std::string::npos, static_cast<u16>(opener), static_cast<u16>(matchedLen), {}});
+                    open.push_back(static_cast<u32>(nodes.size() - 1));
+                }
+                i += matchedLen;
+                continue;
             }
-            scan = nextCloser + 2; // continue after ")}"
+        } else if (s[i] == ')' && i + 1 < size && s[i + 1] == '}') {
+            if (tooDeep) {
+                --tooDeep;
+            } else if (!open.empty()) {
+                const u32 node = open.back();
+                open.pop_back();
+                nodes[node].close = i;
+                (open.empty() ? roots : nodes[open.back()].children).push_back(node);
+            }
+            i += 2;
+            continue;
+        }
+        ++i;
+    }
+
+    while (!open.empty()) {
+        const u32 node = open.back();
+        open.pop_back();
+        auto& target = open.empty() ? roots : nodes[open.back()].children;
+        target.insert(target.end(), nodes[node].children.begin(), nodes[node].children.end());
+    }
+}
+
+static bool resolvePlaceholderNode(const std::string& s, const PlaceholderNode& node,
+                                   const std::vector<PlaceholderNode>& nodes,
+                                   const PlaceholderFunction* functions, const PlaceholderContext& context, std::string& out);
+
+// Appends s[from, to) to out with the given child placeholders resolved
+static bool renderPlaceholderRange(const std::string& s, size_t from, size_t to, const std::vector<u32>& children,
+                                   const std::vector<PlaceholderNode>& nodes,
+                                   const PlaceholderFunction* functions, const PlaceholderContext& context, std::string& out) {
+    bool changed = false;
+    size_t pos = from;
+    for (const u32 child : children) {
+        const PlaceholderNode& node = nodes[child];
+        out.append(s, pos, node.start - pos);
+        changed = resolvePlaceholderNode(s, node, nodes, functions, context, out) || changed;
+        pos = node.close + 2;
+    }
+    out.append(s, pos, to - pos);
+    return changed;
+}
+
+static bool resolvePlaceholderNode(const std::string& s, const PlaceholderNode& node,
+                                   const std::vector<PlaceholderNode>& nodes,
+                                   const PlaceholderFunction* functions, const PlaceholderContext& context, std::string& out) {
+    const size_t innerStart = node.start + node.openerLen;
+    const size_t fullLen = node.close + 2 - node.start;
+
+    std::string resolved;
+    resolved.reserve(fullLen);
+    resolved.append(s, node.start, node.openerLen);
+    const bool innerChanged = renderPlaceholderRange(s, innerStart, node.close, node.children, nodes, functions, context, resolved);
+
+    // Inner placeholders that cannot be resolved here (e.g. source placeholders) keep the whole placeholder intact
+    if (!innerChanged) {
+        const size_t brace = s.find('{', innerStart);
+        if (brace != std::string::npos && brace < node.close) {
+            out.append(s, node.start, fullLen);
+            return false;
         }
     }
+    resolved += ")}";
 
-    return std::string::npos; // unmatched
+    std::string replacement = functions[node.opener].resolve(resolved, context);
+    if (replacement.size() == resolved.size() && replacement == resolved) {
+        out += resolved;
+        return innerChanged;
+    }
+    out += replacement;
+    return true;
 }
 
 
@@ -2908,18 +4173,19 @@ static size_t findMatchingClose(const std::string& s,
  * @brief Recursively resolves nested placeholders in a string from innermost to outermost.
  *
  * This function processes function-style placeholders (e.g., {math(...)}, {split(...)}, {slice(...)})
- * by recursively resolving their inner content first, then applying the outer transformation.
+ * by resolving their inner content first, then applying the outer transformation.
  * It uses a universal approach that attempts to resolve all placeholders it can, and intelligently
  * skips outer placeholders when inner placeholders cannot be resolved (e.g., source placeholders
  * that require external context from getSourceReplacement).
  *
  * Resolution Process:
- * 1. Finds a placeholder pattern like {function(...)}
- * 2. Extracts and recursively resolves the inner content
+ * 1. Scans the string once, matching all openers with a trie, and builds the nesting tree
+ * 2. Resolves the tree bottom-up, so inner content is resolved before its outer placeholder
  * 3. If inner content couldn't be resolved (unchanged and still contains placeholders),
  *    skips the outer placeholder and leaves it intact for later resolution
  * 4. If inner content was successfully resolved, applies the outer function transformation
- * 5. Continues until no more replacements can be made
+ * 5. Rescans while replacements produced new text, until nothing more changes
+ *    (at most PLACEHOLDER_MAX_PASSES times; nesting deeper than PLACEHOLDER_MAX_DEPTH is left as text)
  *
  * Examples:
  * - {split({math(5+5)},",",0)} → Resolves math first (10), then split → Final result
@@ -2927,373 +4193,395 @@ static size_t findMatchingClose(const std::string& s,
  * - {math({ram_vendor}+5)} → ram_vendor already resolved → Processes math → Final result
  *
  * @param arg The string to process, modified in-place with resolved placeholders
- * @param placeholders Vector of placeholder patterns and their resolver functions.
- *                     Each pair contains: opener pattern (e.g., "{math(") and resolver lambda
+ * @param functions Placeholder dispatch table: opener pattern (e.g., "{math(") and resolver
+ * @param trie Opener trie built from the same table
+ * @param context Sources the resolvers read from
  * @return true if any replacements were made, false otherwise
  *
  * @note Simple placeholders like {ram_vendor}, {hos_version} should be resolved by
- *       replacePlaceholdersInArg() before calling this function.
+ *       replaceGeneralPlaceholders() before calling this function.
  * @note Source placeholders like {list_source(*)}, {file_source} are resolved in
  *       getSourceReplacement() and will be skipped by this function.
  */
-static bool replacePlaceholdersRecursivelyImpl(
-    std::string& arg,
-    const std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>>& placeholders,
-    const std::vector<std::string>& starts) {
-    
+bool replacePlaceholdersRecursively(std::string& arg, const PlaceholderFunction* functions,
+                                    const PlaceholderOpenerTrie& trie, const PlaceholderContext& context) {
+    if (arg.find('{') == std::string::npos) return false;
+
+    std::vector<PlaceholderNode> nodes;
+    std::vector<u32> roots;
+    std::string output;
     bool anyReplacementsMade = false;
-    bool replacedThisPass;
-    size_t searchPos;
-    std::string replacement;
-    std::string inner;
-    std::string resolvedPlaceholder;
 
-    for (;;) {
-        replacedThisPass = false;
+    // Resolved values may contain placeholders of their own, so rescan until nothing changes
+    for (size_t pass = 0; pass < PLACEHOLDER_MAX_PASSES; ++pass) {
+        nodes.clear();
+        roots.clear();
+        scanPlaceholderTree(arg, trie, nodes, roots);
+        if (roots.empty()) break;
 
-        for (size_t t = 0; t < placeholders.size(); ++t) {
-            const auto& opener = placeholders[t].first;
-            const auto& replacer = placeholders[t].second;
-            const size_t openerLen = opener.size();
+        output.clear();
+        output.reserve(arg.size());
+        if (!renderPlaceholderRange(arg, 0, arg.size(), roots, nodes, functions, context, output)) break;
 
-            searchPos = 0;
-            while (true) {
-                const size_t startPos = arg.find(opener, searchPos);
-                if (startPos == std::string::npos) break;
+        arg.swap(output);
+        anyReplacementsMade = true;
+        if (arg.find('{') == std::string::npos) break;
+    }
 
-                const size_t closePos = findMatchingClose(arg, startPos, starts, openerLen);
-                if (closePos == std::string::npos) {
-                    searchPos = startPos + openerLen;
-                    continue;
-                }
+    return anyReplacementsMade;
+}
 
-                const size_t innerStart = startPos + openerLen;
-                const size_t innerLen   = closePos - innerStart;
-                const size_t fullLen    = closePos - startPos + 2;
 
-                bool innerChanged = false;
-                
-                // Skip recursion entirely if inner is empty or has no placeholders
-                if (innerLen > 0) {
-                    inner.assign(arg, innerStart, innerLen);
-                    if (inner.find('{') != std::string::npos) {
-                        innerChanged = replacePlaceholdersRecursivelyImpl(inner, placeholders, starts);
-                        
-                        // If recursion made no changes and inner still has unresolved placeholders,
-                        // skip this outer placeholder
-                        if (!innerChanged) {
-                            searchPos = startPos + openerLen;
-                            continue;
-                        }
-                    }
-                }
+/**
+ * @brief Providers for the general placeholders ({local_ip}, {volume}, ...).
+ *
+ * A token is only resolved when it actually appears in an argument. Values that cannot change
+ * after boot are resolved once, service-backed values are cached for a per-token TTL, and
+ * values tied to UI state are read on every use.
+ */
+struct GeneralPlaceholderProvider {
+    std::string_view token;
+    std::string (*resolve)();
+    u64 ttlNs;
+};
 
-                // Build the resolved placeholder
-                if (!innerChanged) {
-                    resolvedPlaceholder.assign(arg, startPos, fullLen);
-                } else {
-                    resolvedPlaceholder.clear();
-                    resolvedPlaceholder.reserve(openerLen + inner.size() + 2);
-                    resolvedPlaceholder += opener;
-                    resolvedPlaceholder += inner;
-                    resolvedPlaceholder += ")}";
-                }
+static constexpr u64 PLACEHOLDER_TTL_LIVE = 0;           // resolved on every use
+static constexpr u64 PLACEHOLDER_TTL_BOOT = UINT64_MAX;  // resolved once per boot
+static constexpr u64 PLACEHOLDER_TTL_MS = 1000000ULL;
+
+static const GeneralPlaceholderProvider generalPlaceholderProviders[] = {
+    {"{ram_vendor}", [] { return memoryVendor; }, PLACEHOLDER_TTL_BOOT},
+    {"{ram_model}", [] { return memoryModel; }, PLACEHOLDER_TTL_BOOT},
+    {"{ams_version}", [] { return std::string(amsVersion); }, PLACEHOLDER_TTL_BOOT},
+    {"{hos_version}", [] { return std::string(hosVersion); }, PLACEHOLDER_TTL_BOOT},
+    {"{package_version}", [] { return packageRootLayerVersion; }, PLACEHOLDER_TTL_LIVE},
+    {"{cpu_speedo}", [] { return ult::to_string(cpuSpeedo0); }, PLACEHOLDER_TTL_BOOT},
+    {"{cpu_iddq}", [] { return ult::to_string(cpuIDDQ); }, PLACEHOLDER_TTL_BOOT},
+    {"{gpu_speedo}", [] { return ult::to_string(cpuSpeedo2); }, PLACEHOLDER_TTL_BOOT},
+    {"{gpu_iddq}", [] { return ult::to_string(gpuIDDQ); }, PLACEHOLDER_TTL_BOOT},
+    {"{soc_speedo}", [] { return ult::to_string(socSpeedo0); }, PLACEHOLDER_TTL_BOOT},
+    {"{soc_iddq}", [] { return ult::to_string(socIDDQ); }, PLACEHOLDER_TTL_BOOT},
+    {"{title_id}", [] { return getTitleIdAsString(); }, 1000 * PLACEHOLDER_TTL_MS},
+    {"{build_id}", [] { return getBuildIdAsString(); }, 1000 * PLACEHOLDER_TTL_MS},
+    {"{local_ip}", [] { return getLocalIpAddress(); }, 5000 * PLACEHOLDER_TTL_MS},
+    {"{volume}", [] { return getMasterVolumeLevel(); }, 250 * PLACEHOLDER_TTL_MS},
+    {"{backlight}", [] { return getBacklightLevel(); }, 250 * PLACEHOLDER_TTL_MS}
+};
 
-                replacement = replacer(resolvedPlaceholder);
+static constexpr size_t GENERAL_PLACEHOLDER_COUNT = sizeof(generalPlaceholderProviders) / sizeof(generalPlaceholderProviders[0]);
 
-                if (replacement.size() == resolvedPlaceholder.size() && replacement == resolvedPlaceholder) {
-                    searchPos = startPos + openerLen;
-                    continue;
-                }
+struct CachedPlaceholderValue {
+    std::string value;
+    u64 expiresAtNs = 0;
+    bool valid = false;
+};
 
-                arg.replace(startPos, fullLen, replacement);
-                anyReplacementsMade = true;
-                replacedThisPass = true;
-                searchPos = startPos + replacement.size();
-            }
-        }
+// Resolved from both the UI thread and the interpreter
+static CachedPlaceholderValue generalPlaceholderCache[GENERAL_PLACEHOLDER_COUNT];
+static std::mutex generalPlaceholderMutex;
+
+static std::string resolveGeneralPlaceholder(size_t index) {
+    const GeneralPlaceholderProvider& provider = generalPlaceholderProviders[index];
+    if (provider.ttlNs == PLACEHOLDER_TTL_LIVE)
+        return provider.resolve();
+
+    std::lock_guard<std::mutex> lock(generalPlaceholderMutex);
+    CachedPlaceholderValue& cached = generalPlaceholderCache[index];
+    const u64 now = armTicksToNs(armGetSystemTick());
+    if (cached.valid && (provider.ttlNs == PLACEHOLDER_TTL_BOOT || now < cached.expiresAtNs))
+        return cached.value;
+
+    cached.value = provider.resolve();
+    cached.expiresAtNs = (provider.ttlNs == PLACEHOLDER_TTL_BOOT) ? PLACEHOLDER_TTL_BOOT : now + provider.ttlNs;
+    cached.valid = true;
+    return cached.value;
+}
 
-        if (!replacedThisPass) break;
+/**
+ * @brief Drops cached general placeholder values so the next use resolves them again.
+ *
+ * @param token Only drop this placeholder (e.g. "{volume}"); empty drops all of them.
+ */
+void invalidateGeneralPlaceholders(std::string_view token = {}) {
+    std::lock_guard<std::mutex> lock(generalPlaceholderMutex);
+    for (size_t i = 0; i < GENERAL_PLACEHOLDER_COUNT; ++i) {
+        if (token.empty() || generalPlaceholderProviders[i].token == token)
+            generalPlaceholderCache[i].valid = false;
     }
-
-    return anyReplacementsMade;
 }
 
-bool replacePlaceholdersRecursively(
-    std::string& arg,
-    const std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>>& placeholders) {
-    
-    if (arg.find('{') == std::string::npos) return false;
+/**
+ * @brief Replaces general placeholders in an argument, resolving only the tokens it contains.
+ *
+ * @return true if any placeholder was replaced.
+ */
+bool replaceGeneralPlaceholders(std::string& arg) {
+    if (arg.find('{') == std::string::npos)
+        return false;
 
-    std::vector<std::string> starts;
-    starts.reserve(placeholders.size());
-    for (const auto& pr : placeholders) {
-        starts.push_back(pr.first);
-    }
-    return replacePlaceholdersRecursivelyImpl(arg, placeholders, starts);
-}
-
-
-std::unordered_map<std::string, std::string> generalPlaceholders;
-void updateGeneralPlaceholders() {
-    generalPlaceholders = {
-        {"{ram_vendor}", memoryVendor},
-        {"{ram_model}", memoryModel},
-        {"{ams_version}", amsVersion},
-        {"{hos_version}", hosVersion},
-        {"{package_version}", packageRootLayerVersion},
-        {"{cpu_speedo}", ult::to_string(cpuSpeedo0)},
-        {"{cpu_iddq}", ult::to_string(cpuIDDQ)},
-        {"{gpu_speedo}", ult::to_string(cpuSpeedo2)},
-        {"{gpu_iddq}", ult::to_string(gpuIDDQ)},
-        {"{soc_speedo}", ult::to_string(socSpeedo0)},
-        {"{soc_iddq}", ult::to_string(socIDDQ)},
-        {"{title_id}", getTitleIdAsString()},
-        {"{build_id}", getBuildIdAsString()},
-        {"{local_ip}", getLocalIpAddress()},
-        {"{volume}", getMasterVolumeLevel()},
-        {"{backlight}", getBacklightLevel()}
-    };
+    bool replaced = false;
+    for (size_t i = 0; i < GENERAL_PLACEHOLDER_COUNT; ++i) {
+        const std::string_view token = generalPlaceholderProviders[i].token;
+        size_t pos = arg.find(token);
+        if (pos == std::string::npos)
+            continue;
+
+        const std::string value = resolveGeneralPlaceholder(i);
+        do {
+            arg.replace(pos, token.size(), value);
+            pos += value.size();
+        } while ((pos = arg.find(token, pos)) != std::string::npos);
+        replaced = true;
+    }
+    return replaced;
 }
 
-bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, 
-                                 const std::string& iniPath, const std::string& listString, 
-                                 const std::string& listPath, const std::string& jsonString, 
-                                 const std::string& jsonPath) {
-    bool replacementsMade = false;
-    
-    std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>> placeholders = {
-        {"{hex_file(", [&](const std::string& placeholder) { 
-            std::string result = replaceHexPlaceholder(placeholder, hexPath);
-            return returnOrNull(result);
-        }},
-        {"{ini_file(", [&](const std::string& placeholder) { 
-            std::string result = placeholder;
-            applyReplaceIniPlaceholder(result, INI_FILE_STR, iniPath); 
-            return result;
-        }},
-        {"{list(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find('(');
-            const size_t closeParen = placeholder.find(')', openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            const std::string indexStr = placeholder.substr(openParen + 1, closeParen - openParen - 1);
-            if (!isValidNumber(indexStr)) {
-                return NULL_STR;
-            }
-            const auto& items = stringToList(listString);
-            const size_t idx = ult::stoi(indexStr);
-            if (idx >= items.size()) {
-                return NULL_STR;
-            }
-            return returnOrNull(items[idx]);
-        }},
-        {"{list_file(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find('(');
-            const size_t closeParen = placeholder.find(')', openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            const std::string indexStr = placeholder.substr(openParen + 1, closeParen - openParen - 1);
-            if (!isValidNumber(indexStr)) {
-                return NULL_STR;
-            }
-            return returnOrNull(getEntryFromListFile(listPath, ult::stoi(indexStr)));
-        }},
-        {"{json(", [&](const std::string& placeholder) { 
-            return replaceJsonPlaceholder(placeholder, JSON_STR, jsonString);
-        }},
-        {"{json_file(", [&](const std::string& placeholder) { 
-            return replaceJsonPlaceholder(placeholder, JSON_FILE_STR, jsonPath);
-        }},
-        {"{timestamp(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            std::string format = (closeParen > openParen + 1) ? 
-                placeholder.substr(openParen + 1, closeParen - openParen - 1) : "%Y-%m-%d %H:%M:%S";
-            removeQuotes(format);
-            return returnOrNull(getCurrentTimestamp(format));
-        }},
-        {"{decimal_to_hex(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            const std::string params = placeholder.substr(openParen + 1, closeParen - openParen - 1);
-            
-            const size_t commaPos = params.find(",");
-            std::string decimalValue;
-            std::string order;
-            
-            if (commaPos != std::string::npos) {
-                decimalValue = params.substr(0, commaPos);
-                order = params.substr(commaPos + 1);
-                order.erase(0, order.find_first_not_of(" \t\n\r"));
-                order.erase(order.find_last_not_of(" \t\n\r") + 1);
-            } else {
-                decimalValue = params;
-                order = "";
-            }
-            
-            if (order.empty()) {
-                return returnOrNull(decimalToHex(decimalValue));
-            } else {
-                if (!isValidNumber(order)) {
-                    return NULL_STR;
-                }
-                return returnOrNull(decimalToHex(decimalValue, ult::stoi(order)));
-            }
-        }},
-        {"{ascii_to_hex(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            return returnOrNull(asciiToHex(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
-        }},
-        {"{hex_to_rhex(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            return returnOrNull(hexToReversedHex(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
-        }},
-        {"{hex_to_decimal(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            return returnOrNull(hexToDecimal(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
-        }},
-        {"{base64_decode(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find("(");
-            const size_t closeParen = placeholder.find(")", openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            return returnOrNull(decodeBase64ToString(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
-        }},
-        {"{random(", [&](const std::string& placeholder) {
-            std::srand(std::time(0));
-            
-            const size_t openParen = placeholder.find('(');
-            const size_t closeParen = placeholder.find(')', openParen + 1);
-            if (openParen == std::string::npos || closeParen == std::string::npos) {
-                return NULL_STR;
-            }
-            const std::string parameters = placeholder.substr(openParen + 1, closeParen - openParen - 1);
-            const size_t commaPos = parameters.find(',');
-            
-            if (commaPos != std::string::npos) {
-                std::string lowStr = parameters.substr(0, commaPos);
-                std::string highStr = parameters.substr(commaPos + 1);
-                
-                if (!isValidNumber(lowStr) || !isValidNumber(highStr)) {
-                    return NULL_STR;
-                }
-                
-                const int lowValue = ult::stoi(lowStr);
-                const int highValue = ult::stoi(highStr);
-                return returnOrNull(ult::to_string(lowValue + rand() % (highValue - lowValue + 1)));
-            }
-            return returnOrNull(placeholder);
-        }},
-        {"{slice(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find('(');
-            const size_t endPos = placeholder.rfind(')');
-            if (startPos == std::string::npos || endPos == std::string::npos || endPos <= startPos + 1) {
-                return NULL_STR;
-            }
-        
-            const std::string parameters = placeholder.substr(startPos + 1, endPos - startPos - 1);
-            const size_t firstComma = parameters.find(',');
-            const size_t secondComma = (firstComma == std::string::npos) ? 
-                std::string::npos : parameters.find(',', firstComma + 1);
-            if (firstComma == std::string::npos || secondComma == std::string::npos) {
-                return NULL_STR;
-            }
-        
-            std::string strPart    = parameters.substr(0, firstComma);
-            std::string startIndex = parameters.substr(firstComma + 1, secondComma - firstComma - 1);
-            std::string endIndex   = parameters.substr(secondComma + 1);
-        
-            trim(strPart);
-            removeQuotes(strPart);
-            trim(startIndex);
-            removeQuotes(startIndex);
-            trim(endIndex);
-            removeQuotes(endIndex);
-        
-            if (startIndex.empty() || endIndex.empty() ||
-                !isValidNumber(startIndex) || !isValidNumber(endIndex)) {
-                return NULL_STR;
-            }
-        
-            const size_t sliceStart = static_cast<size_t>(ult::stoi(startIndex));
-            const size_t sliceEnd   = static_cast<size_t>(ult::stoi(endIndex));
-        
-            if (sliceEnd <= sliceStart || sliceStart >= strPart.length()) {
-                return NULL_STR;
-            }
-        
-            return returnOrNull(sliceString(strPart, sliceStart, sliceEnd));
-        }},
-        {"{split(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find('(');
-            const size_t closeParen = placeholder.rfind(')');
-        
-            if (openParen == std::string::npos || closeParen == std::string::npos || 
-                closeParen <= openParen) {
-                return NULL_STR;
-            }
+/**
+ * @brief Dispatch table for function-style placeholders, built once.
+ *
+ * Resolvers are plain functions; everything they read per command comes from the PlaceholderContext.
+ */
+static const PlaceholderFunction placeholderFunctions[] = {
+    {"{hex_file(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string { 
+        std::string result = getHexFilePlaceholder(placeholder, context.hexPath);
+        return returnOrNull(result);
+    }},
+    {"{ini_file(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string { 
+        std::string result = placeholder;
+        applyReplaceIniPlaceholder(result, INI_FILE_STR, context.iniPath); 
+        return result;
+    }},
+    {"{list(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string {
+        const size_t openParen = placeholder.find('(');
+        const size_t closeParen = placeholder.find(')', openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        const std::string indexStr = placeholder.substr(openParen + 1, closeParen - openParen - 1);
+        if (!isValidNumber(indexStr)) {
+            return NULL_STR;
+        }
+        const auto& items = stringToList(context.listString);
+        const size_t idx = ult::stoi(indexStr);
+        if (idx >= items.size()) {
+            return NULL_STR;
+        }
+        return returnOrNull(items[idx]);
+    }},
+    {"{list_file(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string {
+        const size_t openParen = placeholder.find('(');
+        const size_t closeParen = placeholder.find(')', openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        const std::string indexStr = placeholder.substr(openParen + 1, closeParen - openParen - 1);
+        if (!isValidNumber(indexStr)) {
+            return NULL_STR;
+        }
+        return returnOrNull(getCachedListFileEntry(context.listPath, ult::stoi(indexStr)));
+    }},
+    {"{json(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string { 
+        return replaceJsonPlaceholder(placeholder, JSON_STR, context.jsonString);
+    }},
+    {"{json_file(", [](const std::string& placeholder, const PlaceholderContext& context) -> std::string { 
+        return replaceJsonPlaceholder(placeholder, JSON_FILE_STR, context.jsonPath);
+    }},
+    {"{timestamp(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        std::string format = (closeParen > openParen + 1) ? 
+            placeholder.substr(openParen + 1, closeParen - openParen - 1) : "%Y-%m-%d %H:%M:%S";
+        removeQuotes(format);
+        return returnOrNull(getCurrentTimestamp(format));
+    }},
+    {"{decimal_to_hex(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        const std::string params = placeholder.substr(openParen + 1, closeParen - openParen - 1);
         
-            const std::string parameters = placeholder.substr(openParen + 1, 
-                closeParen - openParen - 1);
+        const size_t commaPos = params.find(",");
+        std::string decimalValue;
+        std::string order;
         
-            const size_t firstCommaPos = parameters.find(',');
-            const size_t lastCommaPos  = parameters.find_last_of(',');
+        if (commaPos != std::string::npos) {
+            decimalValue = params.substr(0, commaPos);
+            order = params.substr(commaPos + 1);
+            order.erase(0, order.find_first_not_of(" \t\n\r"));
+            order.erase(order.find_last_not_of(" \t\n\r") + 1);
+        } else {
+            decimalValue = params;
+            order = "";
+        }
         
-            if (firstCommaPos == std::string::npos || lastCommaPos == std::string::npos ||
-                firstCommaPos == lastCommaPos) {
+        if (order.empty()) {
+            return returnOrNull(decimalToHex(decimalValue));
+        } else {
+            if (!isValidNumber(order)) {
                 return NULL_STR;
             }
+            return returnOrNull(decimalToHex(decimalValue, ult::stoi(order)));
+        }
+    }},
+    {"{ascii_to_hex(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        return returnOrNull(asciiToHex(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
+    }},
+    {"{hex_to_rhex(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        return returnOrNull(hexToReversedHex(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
+    }},
+    {"{hex_to_decimal(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        return returnOrNull(hexToDecimal(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
+    }},
+    {"{base64_decode(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find("(");
+        const size_t closeParen = placeholder.find(")", openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        return returnOrNull(decodeBase64ToString(placeholder.substr(openParen + 1, closeParen - openParen - 1)));
+    }},
+    {"{random(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        std::srand(std::time(0));
         
-            std::string str = parameters.substr(0, firstCommaPos);
-            std::string delimiter = parameters.substr(firstCommaPos + 1, 
-                lastCommaPos - firstCommaPos - 1);
-            std::string indexStr = parameters.substr(lastCommaPos + 1);
-        
-            trim(str);
-            removeQuotes(str);
-            trim(delimiter);
-            removeQuotes(delimiter);
-            trim(indexStr);
+        const size_t openParen = placeholder.find('(');
+        const size_t closeParen = placeholder.find(')', openParen + 1);
+        if (openParen == std::string::npos || closeParen == std::string::npos) {
+            return NULL_STR;
+        }
+        const std::string parameters = placeholder.substr(openParen + 1, closeParen - openParen - 1);
+        const size_t commaPos = parameters.find(',');
         
-            if (indexStr.empty() || !isValidNumber(indexStr)) {
+        if (commaPos != std::string::npos) {
+            std::string lowStr = parameters.substr(0, commaPos);
+            std::string highStr = parameters.substr(commaPos + 1);
+            
+            if (!isValidNumber(lowStr) || !isValidNumber(highStr)) {
                 return NULL_STR;
             }
-        
-            std::string result = splitStringAtIndex(str, delimiter, ult::stoi(indexStr));
-            return result.empty() ? NULL_STR : result;
-        }},
-        {"{math(", [&](const std::string& placeholder) { return handleMath(placeholder); }},
-        {"{length(", [&](const std::string& placeholder) { return handleLength(placeholder); }},
-    };
+            
+            const int lowValue = ult::stoi(lowStr);
+            const int highValue = ult::stoi(highStr);
+            return returnOrNull(ult::to_string(lowValue + rand() % (highValue - lowValue + 1)));
+        }
+        return returnOrNull(placeholder);
+    }},
+    {"{slice(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t startPos = placeholder.find('(');
+        const size_t endPos = placeholder.rfind(')');
+        if (startPos == std::string::npos || endPos == std::string::npos || endPos <= startPos + 1) {
+            return NULL_STR;
+        }
+    
+        const std::string parameters = placeholder.substr(startPos + 1, endPos - startPos - 1);
+        const size_t firstComma = parameters.find(',');
+        const size_t secondComma = (firstComma == std::string::npos) ? 
+            std::string::npos : parameters.find(',', firstComma + 1);
+        if (firstComma == std::string::npos || secondComma == std::string::npos) {
+            return NULL_STR;
+        }
+    
+        std::string strPart    = parameters.substr(0, firstComma);
+        std::string startIndex = parameters.substr(firstComma + 1, secondComma - firstComma - 1);
+        std::string endIndex   = parameters.substr(secondComma + 1);
+    
+        trim(strPart);
+        removeQuotes(strPart);
+        trim(startIndex);
+        removeQuotes(startIndex);
+        trim(endIndex);
+        removeQuotes(endIndex);
+    
+        if (startIndex.empty() || endIndex.empty() ||
+            !isValidNumber(startIndex) || !isValidNumber(endIndex)) {
+            return NULL_STR;
+        }
+    
+        const size_t sliceStart = static_cast<size_t>(ult::stoi(startIndex));
+        const size_t sliceEnd   = static_cast<size_t>(ult::stoi(endIndex));
+    
+        if (sliceEnd <= sliceStart || sliceStart >= strPart.length()) {
+            return NULL_STR;
+        }
+    
+        return returnOrNull(sliceString(strPart, sliceStart, sliceEnd));
+    }},
+    {"{split(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string {
+        const size_t openParen = placeholder.find('(');
+        const size_t closeParen = placeholder.rfind(')');
+    
+        if (openParen == std::string::npos || closeParen == std::string::npos || 
+            closeParen <= openParen) {
+            return NULL_STR;
+        }
+    
+        const std::string parameters = placeholder.substr(openParen + 1, 
+            closeParen - openParen - 1);
+    
+        const size_t firstCommaPos = parameters.find(',');
+        const size_t lastCommaPos  = parameters.find_last_of(',');
+    
+        if (firstCommaPos == std::string::npos || lastCommaPos == std::string::npos ||
+            firstCommaPos == lastCommaPos) {
+            return NULL_STR;
+        }
+    
+        std::string str = parameters.substr(0, firstCommaPos);
+        std::string delimiter = parameters.substr(firstCommaPos + 1, 
+            lastCommaPos - firstCommaPos - 1);
+        std::string indexStr = parameters.substr(lastCommaPos + 1);
+    
+        trim(str);
+        removeQuotes(str);
+        trim(delimiter);
+        removeQuotes(delimiter);
+        trim(indexStr);
+    
+        if (indexStr.empty() || !isValidNumber(indexStr)) {
+            return NULL_STR;
+        }
+    
+        std::string result = splitStringAtIndex(str, delimiter, ult::stoi(indexStr));
+        return result.empty() ? NULL_STR : result;
+    }},
+    {"{math(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string { return handleMath(placeholder); }},
+    {"{length(", [](const std::string& placeholder, const PlaceholderContext&) -> std::string { return handleLength(placeholder); }},
+};
 
-    updateGeneralPlaceholders();
+static constexpr size_t PLACEHOLDER_FUNCTION_COUNT = sizeof(placeholderFunctions) / sizeof(placeholderFunctions[0]);
+static const PlaceholderOpenerTrie placeholderOpenerTrie(placeholderFunctions, PLACEHOLDER_FUNCTION_COUNT);
+
+bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, 
+                                 const std::string& iniPath, const std::string& listString, 
+                                 const std::string& listPath, const std::string& jsonString, 
+                                 const std::string& jsonPath) {
+    bool replacementsMade = false;
+    
+    const PlaceholderContext context{hexPath, iniPath, listString, listPath, jsonString, jsonPath};
 
     // Iterate through each command and replace placeholders
     for (auto& arg : cmd) {
         // Replace general placeholders
-        if (replacePlaceholdersInArg(arg, generalPlaceholders)) {
+        if (replaceGeneralPlaceholders(arg)) {
             replacementsMade = true;
         }
 
@@ -3303,7 +4591,7 @@ bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::stri
         }
 
         // Resolve nested placeholders - only if all internals resolve
-        if (replacePlaceholdersRecursively(arg, placeholders)) {
+        if (replacePlaceholdersRecursively(arg, placeholderFunctions, placeholderOpenerTrie, context)) {
             replacementsMade = true;
         }
     }
@@ -3313,8 +4601,320 @@ bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::stri
 
 
 
+/**
+ * @brief Opcodes for every command understood by the interpreter.
+ *
+ * Command names are resolved to an opcode once when a section is compiled, so
+ * execution can dispatch on an integer instead of re-comparing strings.
+ * Aliases (e.g. "cp" / "copy") share a single opcode.
+ */
+enum class CommandOpcode : u8 {
+    Unknown = 0,
+    Dynamic,            // command name contains a placeholder; resolved after replacement
+
+    // Interpreter control flow and state
+    Try,
+    Erista,
+    Mariko,
+    Parallel,
+    EndParallel,
+    List,
+    ListFile,
+    Json,
+    JsonFile,
+    IniFile,
+    HexFile,
+
+    // Executable commands
+    IniCommand,
+    JsonCommand,
+    Back,
+    Backlight,
+    Copy,
+    Compare,
+    Clear,
+    Delete,
+    Download,
+    DownloadNoRetry,
+    DotClean,
+    Exec,
+    Exit,
+    Flag,
+    HexEdit,
+    Logging,
+    MakeDir,
+    Move,
+    Mirror,
+    Notify,
+    Open,
+    PathExists,
+    NotPathExists,
+    Pchtxt2Ips,
+    Pchtxt2Cheat,
+    Profile,
+    Refresh,
+    RefreshTo,
+    Reboot,
+    SetFooter,
+    SetRegion,
+    Shutdown,
+    Unzip,
+    Volume
+};
+
+/**
+ * @brief Resolves a command name to its opcode.
+ *
+ * @param commandName The first token of a command.
+ * @return The matching opcode, or CommandOpcode::Unknown if the name is not a command.
+ */
+CommandOpcode getCommandOpcode(std::string_view commandName) {
+    static const std::unordered_map<std::string_view, CommandOpcode> opcodeTable = {
+        {"try:", CommandOpcode::Try},
+        {"erista:", CommandOpcode::Erista},
+        {"mariko:", CommandOpcode::Mariko},
+        {"parallel:", CommandOpcode::Parallel},
+        {"end-parallel:", CommandOpcode::EndParallel},
+        {"list", CommandOpcode::List},
+        {"list_file", CommandOpcode::ListFile},
+        {"json", CommandOpcode::Json},
+        {"json_file", CommandOpcode::JsonFile},
+        {"ini_file", CommandOpcode::IniFile},
+        {"hex_file", CommandOpcode::HexFile},
+
+        {"add-ini-section", CommandOpcode::IniCommand},
+        {"rename-ini-section", CommandOpcode::IniCommand},
+        {"remove-ini-section", CommandOpcode::IniCommand},
+        {"remove-ini-key", CommandOpcode::IniCommand},
+        {"remove-ini-key-matching-key", CommandOpcode::IniCommand},
+        {"set-ini-val", CommandOpcode::IniCommand},
+        {"set-ini-value", CommandOpcode::IniCommand},
+        {"set-ini-key", CommandOpcode::IniCommand},
+        {"set-ini-val-matching-key", CommandOpcode::IniCommand},
+        {"set-json-val", CommandOpcode::JsonCommand},
+        {"set-json-value", CommandOpcode::JsonCommand},
+        {"set-json-key", CommandOpcode::JsonCommand},
+        {"back", CommandOpcode::Back},
+        {"backlight", CommandOpcode::Backlight},
+        {"cp", CommandOpcode::Copy},
+        {"copy", CommandOpcode::Copy},
+        {"compare", CommandOpcode::Compare},
+        {"clear", CommandOpcode::Clear},
+        {"del", CommandOpcode::Delete},
+        {"delete", CommandOpcode::Delete},
+        {"download", CommandOpcode::Download},
+        {"download-no-retry", CommandOpcode::DownloadNoRetry},
+        {"dot-clean", CommandOpcode::DotClean},
+        {"exec", CommandOpcode::Exec},
+        {"exit", CommandOpcode::Exit},
+        {"flag", CommandOpcode::Flag},
+        {"logging", CommandOpcode::Logging},
+        {"mkdir", CommandOpcode::MakeDir},
+        {"make", CommandOpcode::MakeDir},
+        {"mv", CommandOpcode::Move},
+        {"move", CommandOpcode::Move},
+        {"rename", CommandOpcode::Move},
+        {"notify", CommandOpcode::Notify},
+        {"notification", CommandOpcode::Notify},
+        {"notify-now", CommandOpcode::Notify},
+        {"notification-now", CommandOpcode::Notify},
+        {"open", CommandOpcode::Open},
+        {"path_exists", CommandOpcode::PathExists},
+        {"!path_exists", CommandOpcode::NotPathExists},
+        {"pchtxt2ips", CommandOpcode::Pchtxt2Ips},
+        {"pchtxt2cheat", CommandOpcode::Pchtxt2Cheat},
+        {"profile", CommandOpcode::Profile},
+        {"refresh", CommandOpcode::Refresh},
+        {"refresh-to", CommandOpcode::RefreshTo},
+        {"reboot", CommandOpcode::Reboot},
+        {"set-footer", CommandOpcode::SetFooter},
+        {"set-region", CommandOpcode::SetRegion},
+        {"shutdown", CommandOpcode::Shutdown},
+        {"unzip", CommandOpcode::Unzip},
+        {"volume", CommandOpcode::Volume}
+    };
+
+    const auto it = opcodeTable.find(commandName);
+    if (it != opcodeTable.end()) {
+        return it->second;
+    }
+
+    // Prefix families (any suffix is accepted by their handlers)
+    if (commandName.compare(0, 7, "hex-by-") == 0) {
+        return CommandOpcode::HexEdit;
+    }
+    if (commandName.compare(0, 7, "mirror_") == 0) {
+        return CommandOpcode::Mirror;
+    }
+    if (commandName.find('{') != std::string_view::npos) {
+        return CommandOpcode::Dynamic;
+    }
+    return CommandOpcode::Unknown;
+}
+
+// A single command lowered to its opcode plus any operand that can be resolved ahead of time
+struct CompiledCommand {
+    CommandOpcode opcode = CommandOpcode::Unknown;
+    std::string name;              // first token the opcode was resolved from
+    bool hasOperand = false;       // true if operand was built from argument (no placeholders)
+    std::string argument;          // raw first argument of a list/json/ini/hex source command
+    std::string operand;           // pre-processed argument
+};
+
+using CompiledSection = std::vector<CompiledCommand>;
+
+/**
+ * @brief Pre-processes the first argument of a source-setting command.
+ *
+ * Quotes are stripped for inline list/json strings, file paths are passed through preprocessPath.
+ */
+inline std::string compileCommandOperand(CommandOpcode opcode, const std::string& arg, const std::string& packagePath) {
+    std::string operand = arg;
+    switch (opcode) {
+        case CommandOpcode::List:
+        case CommandOpcode::Json:
+            removeQuotes(operand);
+            break;
+        case CommandOpcode::ListFile:
+        case CommandOpcode::JsonFile:
+        case CommandOpcode::IniFile:
+        case CommandOpcode::HexFile:
+            preprocessPath(operand, packagePath);
+            break;
+        default:
+            break;
+    }
+    return operand;
+}
+
+// Compiled sections are keyed by package path and section name, and dropped when the package's
+// package.ini changes. Sources substitute their entry into the same section, so a hit is also
+// checked against the tokens the compilation was built from (first token, source argument).
+struct CachedCompiledSection {
+    s64 packageMtime;
+    std::shared_ptr<const CompiledSection> compiled;
+};
+
+static std::mutex compiledSectionMutex;
+static std::unordered_map<std::string, CachedCompiledSection> compiledSectionCache;
+static constexpr size_t COMPILED_SECTION_CACHE_LIMIT = 32;
+
+inline bool commandHasPlaceholders(const std::vector<std::string>& cmd) {
+    for (const auto& token : cmd) {
+        if (token.find('{') != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+// True if a placeholder in the command is named after a file source command ({ini_file(...)},
+// {json_file(...)}, {list_file(...)}, {hex_file(...)}) and so reads a file when it is resolved
+inline bool readsSourceFile(const std::vector<std::string>& cmd) {
+    for (const auto& token : cmd) {
+        for (size_t open = token.find('{'); open != std::string::npos; open = token.find('{', open + 1)) {
+            const size_t paren = token.find('(', open + 1);
+            if (paren == std::string::npos)
+                break;
+            switch (getCommandOpcode(std::string_view(token).substr(open + 1, paren - open - 1))) {
+                case CommandOpcode::ListFile:
+                case CommandOpcode::JsonFile:
+                case CommandOpcode::IniFile:
+                case CommandOpcode::HexFile:
+                    return true;
+                default:
+                    break;
+            }
+        }
+    }
+    return false;
+}
+
+inline bool compiledSectionMatches(const CompiledSection& compiled, const std::vector<std::vector<std::string>>& commands) {
+    if (compiled.size() != commands.size())
+        return false;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const auto& cmd = commands[i];
+        const CompiledCommand& compiledCmd = compiled[i];
+        if (cmd.empty()) {
+            if (!compiledCmd.name.empty())
+                return false;
+            continue;
+        }
+        if (cmd[0] != compiledCmd.name)
+            return false;
+        if (compiledCmd.hasOperand && (cmd.size() < 2 || cmd[1] != compiledCmd.argument))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Compiles a command section into opcodes, reusing a cached compilation when available.
+ *
+ * The same section of the same package is only compiled once; later runs share the cached
+ * result. The cache is bounded and simply reset once full.
+ *
+ * @param commands The raw command list.
+ * @param packagePath The package path used to resolve relative operands.
+ * @param sectionName The section the commands were loaded from.
+ * @return A shared, immutable compiled section with one entry per command.
+ */
+std::shared_ptr<const CompiledSection> getCompiledSection(const std::vector<std::vector<std::string>>& commands,
+                                                          const std::string& packagePath, const std::string& sectionName) {
+    std::string key = packagePath;
+    key += '\n';
+    key += sectionName;
+
+    struct stat st;
+    const s64 packageMtime = (!packagePath.empty() && stat((packagePath + PACKAGE_FILENAME).c_str(), &st) == 0)
+                             ? static_cast<s64>(st.st_mtime) : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(compiledSectionMutex);
+        const auto it = compiledSectionCache.find(key);
+        if (it != compiledSectionCache.end() && it->second.packageMtime == packageMtime &&
+            compiledSectionMatches(*it->second.compiled, commands)) {
+            return it->second.compiled;
+        }
+    }
+
+    auto compiled = std::make_shared<CompiledSection>(commands.size());
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const auto& cmd = commands[i];
+        if (cmd.empty()) {
+            continue;
+        }
+
+        CompiledCommand& out = (*compiled)[i];
+        out.name = cmd[0];
+        out.opcode = getCommandOpcode(cmd[0]);
+
+        if (cmd.size() >= 2 && out.opcode >= CommandOpcode::List && out.opcode <= CommandOpcode::HexFile &&
+            !commandHasPlaceholders(cmd)) {
+            out.hasOperand = true;
+            out.argument = cmd[1];
+            out.operand = compileCommandOperand(out.opcode, cmd[1], packagePath);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(compiledSectionMutex);
+    if (compiledSectionCache.size() >= (ult::limitedMemory ? COMPILED_SECTION_CACHE_LIMIT / 4 : COMPILED_SECTION_CACHE_LIMIT) &&
+        compiledSectionCache.find(key) == compiledSectionCache.end()) {
+        compiledSectionCache.clear();
+    }
+    compiledSectionCache[key] = {packageMtime, compiled};
+    return compiled;
+}
+
+void clearCompiledSectionCache() {
+    std::lock_guard<std::mutex> lock(compiledSectionMutex);
+    compiledSectionCache.clear();
+}
+
+
 // forward declarartion
-void processCommand(const std::vector<std::string>& cmd, const std::string& packagePath, const std::string& selectedCommand);
+void processCommand(CommandOpcode opcode, const std::vector<std::string>& cmd, const std::string& packagePath, const std::string& selectedCommand);
+void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& packagePath, std::atomic<int>* percentage);
 
 
 /**
@@ -3457,15 +5057,994 @@ bool applyPlaceholderReplacementsToCommands(std::vector<std::vector<std::string>
         ++writeIndex;
     }
     
-    // Resize to keep only the commands we want
-    commands.resize(writeIndex);
-    commands.shrink_to_fit();  // Always - maximize memory efficiency
-
-    return true;
+    // Resize to keep only the commands we want
+    commands.resize(writeIndex);
+    commands.shrink_to_fit();  // Always - maximize memory efficiency
+
+    return true;
+}
+
+
+
+/**
+ * @brief Per-command execution profiler.
+ *
+ * Enabled for the rest of a run by the `profile` command. Each executed command appends one
+ * record to a fixed-size ring buffer; when the outermost run finishes, the records are written
+ * to `profile.csv` next to the package's `log.txt` (or `profile.json` via writeCommandProfile).
+ * Used SD space is sampled only when profiling starts and when the profile is written, since a
+ * statvfs() around every command costs more than many of the commands being timed.
+ */
+std::atomic<bool> interpreterProfiling{false};
+
+struct CommandProfileRecord {
+    char name[32];
+    u64 wallNs;          // total time for the command, including placeholder expansion
+    u64 placeholderNs;   // time spent in applyPlaceholderReplacements
+    s64 heapDelta;       // change in allocated heap in bytes
+};
+
+static constexpr size_t COMMAND_PROFILE_CAPACITY = 128;
+static CommandProfileRecord commandProfileRing[COMMAND_PROFILE_CAPACITY];
+static size_t commandProfileCount = 0;  // total records pushed; ring index is count % capacity
+static std::string commandProfilePackagePath;
+static s64 commandProfileStorageStart = 0;  // used SD space when profiling started
+static std::mutex commandProfileMutex;
+
+inline s64 getHeapInUse() {
+    const struct mallinfo info = mallinfo();
+    return static_cast<s64>(info.uordblks);
+}
+
+inline s64 getStorageInUse() {
+    struct statvfs st;
+    if (statvfs(ROOT_PATH.c_str(), &st) != 0) {
+        return 0;
+    }
+    return static_cast<s64>(st.f_blocks - st.f_bfree) * static_cast<s64>(st.f_frsize);
+}
+
+void clearCommandProfile(const std::string& packagePath = "") {
+    std::lock_guard<std::mutex> lock(commandProfileMutex);
+    commandProfileCount = 0;
+    commandProfilePackagePath = packagePath;
+    commandProfileStorageStart = getStorageInUse();
+}
+
+void recordCommandProfile(const std::string& name, u64 wallNs, u64 placeholderNs, s64 heapDelta) {
+    std::lock_guard<std::mutex> lock(commandProfileMutex);
+    CommandProfileRecord& record = commandProfileRing[commandProfileCount % COMMAND_PROFILE_CAPACITY];
+    strncpy(record.name, name.c_str(), sizeof(record.name) - 1);
+    record.name[sizeof(record.name) - 1] = '\0';
+    record.wallNs = wallNs;
+    record.placeholderNs = placeholderNs;
+    record.heapDelta = heapDelta;
+    ++commandProfileCount;
+}
+
+/**
+ * @brief Returns the recorded profile, oldest record first.
+ *
+ * @param packagePath If not empty, only return records if they were captured for this package.
+ */
+std::vector<CommandProfileRecord> getCommandProfile(const std::string& packagePath = "") {
+    std::lock_guard<std::mutex> lock(commandProfileMutex);
+    std::vector<CommandProfileRecord> records;
+    if (!packagePath.empty() && packagePath != commandProfilePackagePath) {
+        return records;
+    }
+    const size_t count = std::min(commandProfileCount, COMMAND_PROFILE_CAPACITY);
+    records.reserve(count);
+    for (size_t i = commandProfileCount - count; i < commandProfileCount; ++i) {
+        records.push_back(commandProfileRing[i % COMMAND_PROFILE_CAPACITY]);
+    }
+    return records;
+}
+
+/**
+ * @brief Writes the recorded profile to a file, as JSON if the path ends in ".json", CSV otherwise.
+ *
+ * A final "total" row sums the records and carries the change in used SD space over the run.
+ *
+ * @return true if the file was written.
+ */
+bool writeCommandProfile(const std::string& outputPath) {
+    const auto records = getCommandProfile();
+    if (records.empty()) {
+        return false;
+    }
+
+    s64 storageDelta;
+    {
+        std::lock_guard<std::mutex> lock(commandProfileMutex);
+        storageDelta = getStorageInUse() - commandProfileStorageStart;
+    }
+
+    CommandProfileRecord total = {"total", 0, 0, 0};
+    for (const auto& r : records) {
+        total.wallNs += r.wallNs;
+        total.placeholderNs += r.placeholderNs;
+        total.heapDelta += r.heapDelta;
+    }
+
+    FILE* file = fopen(outputPath.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    const bool asJson = outputPath.size() >= 5 && outputPath.compare(outputPath.size() - 5, 5, ".json") == 0;
+    if (asJson) {
+        fputs("[\n", file);
+    } else {
+        fputs("command,wall_us,placeholder_us,storage_delta,heap_delta\n", file);
+    }
+
+    for (const auto& r : records) {
+        if (asJson) {
+            fprintf(file, "  {\"command\": \"%s\", \"wall_us\": %llu, \"placeholder_us\": %llu, \"heap_delta\": %lld},\n",
+                    r.name, static_cast<unsigned long long>(r.wallNs / 1000), static_cast<unsigned long long>(r.placeholderNs / 1000),
+                    static_cast<long long>(r.heapDelta));
+        } else {
+            fprintf(file, "%s,%llu,%llu,,%lld\n",
+                    r.name, static_cast<unsigned long long>(r.wallNs / 1000), static_cast<unsigned long long>(r.placeholderNs / 1000),
+                    static_cast<long long>(r.heapDelta));
+        }
+    }
+
+    if (asJson) {
+        fprintf(file, "  {\"command\": \"%s\", \"wall_us\": %llu, \"placeholder_us\": %llu, \"storage_delta\": %lld, \"heap_delta\": %lld}\n",
+                total.name, static_cast<unsigned long long>(total.wallNs / 1000), static_cast<unsigned long long>(total.placeholderNs / 1000),
+                static_cast<long long>(storageDelta), static_cast<long long>(total.heapDelta));
+    } else {
+        fprintf(file, "%s,%llu,%llu,%lld,%lld\n",
+                total.name, static_cast<unsigned long long>(total.wallNs / 1000), static_cast<unsigned long long>(total.placeholderNs / 1000),
+                static_cast<long long>(storageDelta), static_cast<long long>(total.heapDelta));
+    }
+
+    if (asJson) {
+        fputs("]\n", file);
+    }
+    fclose(file);
+    return true;
+}
+
+// Nesting depth of interpretAndExecuteCommands (exec runs nested sections)
+static int interpreterRunDepth = 0;
+
+
+/**
+ * @brief Process-wide snapshot of the [memory] section of config.ini.
+ *
+ * The section is parsed again only when config.ini's size or mtime changes (so manual edits are
+ * picked up), or after invalidateMemoryConfig() for writes to [memory] that may land within the
+ * same mtime tick.
+ */
+static std::atomic<bool> memoryConfigDirty{true};
+static std::mutex memoryConfigMutex;
+static int memoryConfigStackSize = 0x8000;
+static s64 memoryConfigFileSize = -1;
+static s64 memoryConfigFileMtime = 0;
+
+void invalidateMemoryConfig() {
+    memoryConfigDirty.store(true, std::memory_order_release);
+}
+
+void loadMemoryConfig() {
+    struct stat st;
+    const bool exists = stat(ULTRAHAND_CONFIG_INI_PATH.c_str(), &st) == 0;
+    const s64 size = exists ? static_cast<s64>(st.st_size) : -1;
+    const s64 mtime = exists ? static_cast<s64>(st.st_mtime) : 0;
+
+    std::lock_guard<std::mutex> lock(memoryConfigMutex);
+    if (!memoryConfigDirty.exchange(false, std::memory_order_acq_rel) &&
+        size == memoryConfigFileSize && mtime == memoryConfigFileMtime)
+        return;
+    memoryConfigFileSize = size;
+    memoryConfigFileMtime = mtime;
+
+    const auto bufferSection = getKeyValuePairsFromSection(ULTRAHAND_CONFIG_INI_PATH, MEMORY_STR);
+    
+    struct BufferConfig {
+        const char* key;
+        size_t* target;
+    };
+    
+    const BufferConfig configs[] = {
+        {"copy_buffer_size", &COPY_BUFFER_SIZE},
+        {"unzip_read_buffer", &UNZIP_READ_BUFFER},
+        {"unzip_write_buffer", &UNZIP_WRITE_BUFFER},
+        {"download_read_buffer", &DOWNLOAD_READ_BUFFER},
+        {"download_write_buffer", &DOWNLOAD_WRITE_BUFFER},
+        {"hex_buffer_size", &HEX_BUFFER_SIZE}
+    };
+    
+    for (const auto& config : configs) {
+        const auto it = bufferSection.find(config.key);
+        if (it != bufferSection.end()) {
+            *config.target = ult::stoi(it->second);
+        }
+    }
+
+    // Interpreter stack size is stored as hex, with or without a "0x" prefix
+    memoryConfigStackSize = 0x8000;  // Default if missing or invalid
+    const auto heapIt = bufferSection.find("interpreter_heap");
+    if (heapIt != bufferSection.end()) {
+        std::string interpreterHeap = heapIt->second;
+        if (interpreterHeap.size() > 2 && interpreterHeap[0] == '0' &&
+            (interpreterHeap[1] == 'x' || interpreterHeap[1] == 'X')) {
+            interpreterHeap = interpreterHeap.substr(2);
+        }
+
+        bool validHex = !interpreterHeap.empty();
+        for (char c : interpreterHeap) {
+            if (!std::isxdigit(static_cast<unsigned char>(c))) {
+                validHex = false;
+                break;
+            }
+        }
+
+        if (validHex) {
+            memoryConfigStackSize = ult::stoi(interpreterHeap, nullptr, 16);  // Convert from base 16
+        }
+    }
+}
+
+
+/**
+ * @brief One '/'-separated segment of a wildcard path, compiled for matching.
+ *
+ * Literal segments and segments with a single '*' (prefix*, *suffix, prefix*suffix) are
+ * matched with plain comparisons; anything else ('?', '[...]', several '*') uses fnmatch().
+ */
+struct GlobSegment {
+    enum Kind : u8 { LITERAL, ANY, PREFIX, SUFFIX, PREFIX_SUFFIX, COMPLEX };
+    Kind kind = LITERAL;
+    std::string text;    // the whole segment (LITERAL, COMPLEX)
+    std::string prefix;
+    std::string suffix;
+
+    explicit GlobSegment(std::string segment) : text(std::move(segment)) {
+        if (text.find_first_of("?[\\") != std::string::npos) {
+            kind = COMPLEX;
+            return;
+        }
+        const size_t star = text.find('*');
+        if (star == std::string::npos) {
+            kind = LITERAL;
+        } else if (text.find_first_not_of('*') == std::string::npos) {
+            kind = ANY;
+        } else if (text.find('*', star + 1) != std::string::npos) {
+            kind = COMPLEX;
+        } else {
+            prefix = text.substr(0, star);
+            suffix = text.substr(star + 1);
+            kind = prefix.empty() ? SUFFIX : (suffix.empty() ? PREFIX : PREFIX_SUFFIX);
+        }
+    }
+
+    bool matches(const std::string& name) const {
+        switch (kind) {
+            case LITERAL:
+                return name == text;
+            case ANY:
+                return true;
+            case PREFIX:
+                return name.compare(0, prefix.size(), prefix) == 0;
+            case SUFFIX:
+                return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+            case PREFIX_SUFFIX:
+                return name.size() >= prefix.size() + suffix.size() &&
+                       name.compare(0, prefix.size(), prefix) == 0 &&
+                       name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+            default:
+                return fnmatch(text.c_str(), name.c_str(), 0) == 0;
+        }
+    }
+};
+
+/**
+ * @brief Short-lived cache of directory listings for wildcard lookups.
+ *
+ * A selection menu resolves its filter, file_source, file_source_on and file_source_off
+ * patterns back to back, usually over the same folders, so each folder is read once per menu
+ * build. Listings expire after DIRECTORY_LISTING_TTL_NS and are dropped whenever the
+ * interpreter runs a command that can change the file tree.
+ */
+struct DirectoryListing {
+    std::string path;
+    u64 createdNs = 0;
+    std::vector<std::pair<std::string, bool>> entries;  // name, isDirectory (sorted by name)
+};
+
+static constexpr u64 DIRECTORY_LISTING_TTL_NS = 1000000000ULL;
+static constexpr size_t DIRECTORY_LISTING_CACHE_LIMIT = 16;
+static std::vector<std::shared_ptr<const DirectoryListing>> directoryListingCache;  // most recently used first
+static std::mutex directoryListingMutex;
+
+void clearDirectoryListingCache() {
+    std::lock_guard<std::mutex> lock(directoryListingMutex);
+    directoryListingCache.clear();
+}
+
+static std::shared_ptr<const DirectoryListing> getDirectoryListing(const std::string& path) {
+    const u64 now = armTicksToNs(armGetSystemTick());
+    {
+        std::lock_guard<std::mutex> lock(directoryListingMutex);
+        for (auto it = directoryListingCache.begin(); it != directoryListingCache.end(); ++it) {
+            if ((*it)->path == path) {
+                if (now - (*it)->createdNs < DIRECTORY_LISTING_TTL_NS) {
+                    std::rotate(directoryListingCache.begin(), it, it + 1);
+                    return directoryListingCache.front();
+                }
+                directoryListingCache.erase(it);  // expired
+                break;
+            }
+        }
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir)
+        return nullptr;
+
+    auto listing = std::make_shared<DirectoryListing>();
+    listing->path = path;
+    listing->createdNs = now;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+            continue;
+
+        bool isDir;
+        if (entry->d_type == DT_DIR || entry->d_type == DT_REG) {
+            isDir = entry->d_type == DT_DIR;
+        } else {
+            struct stat st;
+            isDir = stat((path + entry->d_name).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        }
+        listing->entries.emplace_back(entry->d_name, isDir);
+    }
+    closedir(dir);
+    std::sort(listing->entries.begin(), listing->entries.end());
+
+    std::lock_guard<std::mutex> lock(directoryListingMutex);
+    directoryListingCache.insert(directoryListingCache.begin(), listing);
+    const size_t limit = ult::limitedMemory ? DIRECTORY_LISTING_CACHE_LIMIT / 4 : DIRECTORY_LISTING_CACHE_LIMIT;
+    if (directoryListingCache.size() > limit)
+        directoryListingCache.resize(limit);
+    return listing;
+}
+
+/**
+ * @brief Cached, compiled replacement for getFilesListByWildcards().
+ *
+ * Every segment of the pattern may contain wildcards. A pattern ending in '/' matches
+ * directories (returned with a trailing '/'), otherwise files.
+ *
+ * @param pathPattern The wildcard path, e.g. OVERLAY_PATH + "*.ovl".
+ * @param maxItems Stop after this many matches (0 = no limit).
+ * @return Matching paths in name order.
+ */
+std::vector<std::string> getCachedFilesListByWildcards(const std::string& pathPattern, size_t maxItems = 0) {
+    std::vector<std::string> results;
+
+    const bool matchDirectories = !pathPattern.empty() && pathPattern.back() == '/';
+    const size_t wildcardPos = pathPattern.find_first_of("*?[");
+    if (wildcardPos == std::string::npos)
+        return results;
+
+    // Everything before the first wildcard segment is walked as-is
+    const size_t baseEnd = pathPattern.rfind('/', wildcardPos);
+    if (baseEnd == std::string::npos)
+        return results;
+    const std::string basePath = pathPattern.substr(0, baseEnd + 1);
+
+    std::vector<GlobSegment> segments;
+    size_t start = baseEnd + 1;
+    while (start < pathPattern.size()) {
+        size_t end = pathPattern.find('/', start);
+        if (end == std::string::npos)
+            end = pathPattern.size();
+        if (end > start)
+            segments.emplace_back(pathPattern.substr(start, end - start));
+        start = end + 1;
+    }
+    if (segments.empty())
+        return results;
+
+    // Depth-first over (directory, segment index)
+    std::vector<std::pair<std::string, size_t>> pending;
+    pending.emplace_back(basePath, 0);
+
+    while (!pending.empty()) {
+        auto [directory, index] = std::move(pending.back());
+        pending.pop_back();
+
+        const GlobSegment& segment = segments[index];
+        const bool lastSegment = index + 1 == segments.size();
+
+        // Literal directories along the way do not need a listing
+        if (segment.kind == GlobSegment::LITERAL && !lastSegment) {
+            pending.emplace_back(directory + segment.text + '/', index + 1);
+            continue;
+        }
+
+        const auto listing = getDirectoryListing(directory);
+        if (!listing)
+            continue;
+
+        // Pushed in reverse so the stack pops them in name order
+        const size_t firstPending = pending.size();
+        for (const auto& [name, isDir] : listing->entries) {
+            if (!segment.matches(name))
+                continue;
+
+            if (!lastSegment) {
+                if (isDir)
+                    pending.emplace_back(directory + name + '/', index + 1);
+            } else if (isDir == matchDirectories) {
+                results.push_back(directory + name + (isDir ? "/" : ""));
+                if (maxItems && results.size() >= maxItems)
+                    return results;
+            }
+        }
+        std::reverse(pending.begin() + firstPending, pending.end());
+    }
+
+    return results;
+}
+
+/**
+ * @brief Whether a command can add, remove or rename entries on the SD card.
+ */
+inline bool changesFileTree(CommandOpcode opcode) {
+    switch (opcode) {
+        case CommandOpcode::Copy:
+        case CommandOpcode::Compare:
+        case CommandOpcode::Clear:
+        case CommandOpcode::Delete:
+        case CommandOpcode::Download:
+        case CommandOpcode::DownloadNoRetry:
+        case CommandOpcode::DotClean:
+        case CommandOpcode::Exec:
+        case CommandOpcode::IniCommand:
+        case CommandOpcode::JsonCommand:
+        case CommandOpcode::MakeDir:
+        case CommandOpcode::Move:
+        case CommandOpcode::Mirror:
+        case CommandOpcode::Pchtxt2Ips:
+        case CommandOpcode::Pchtxt2Cheat:
+        case CommandOpcode::Unzip:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Drops listings and parsed files that a change to the file tree may have made stale.
+ *
+ * A same-size rewrite can land within the same FAT mtime tick, so they are not revalidated.
+ */
+void invalidateFileCaches() {
+    clearDirectoryListingCache();
+    clearJsonDocumentCache();
+    clearIniIndexCache();
+    clearHexFileImageCache();
+}
+
+
+/**
+ * @brief Write-behind buffer for consecutive INI edits made by the interpreter.
+ *
+ * set-ini-val and remove-ini-key are queued instead of run one by one, and a later edit of the
+ * same key replaces a queued edit of the same kind, so a key set many times in a run is written
+ * once. flushIniWriteBuffer() replays the queue in order through libultrahand's setIniFileValue()
+ * and removeIniKey(), so the file ends up exactly as if every command had run directly. The
+ * interpreter calls it before any command that could observe the file, and at the end of a run.
+ *
+ * Only same-kind edits are merged: a set never moves an existing key, so setting it again in
+ * place equals setting it once with the last value, but a remove followed by a set re-adds the
+ * key at the end of its section and a set followed by a remove may leave a created section.
+ */
+struct BufferedIniEdit {
+    std::string path;
+    std::string section;
+    std::string key;
+    std::string value;
+    bool remove;
+};
+
+// Only touched from the interpreter thread
+static std::vector<BufferedIniEdit> iniWriteBuffer;
+
+/**
+ * @brief Runs all queued INI edits through libultrahand and empties the buffer.
+ */
+void flushIniWriteBuffer() {
+    if (iniWriteBuffer.empty())
+        return;
+
+    for (const auto& edit : iniWriteBuffer) {
+        if (edit.remove)
+            removeIniKey(edit.path, edit.section, edit.key);
+        else
+            setIniFileValue(edit.path, edit.section, edit.key, edit.value);
+
+        if (edit.path == ULTRAHAND_CONFIG_INI_PATH && edit.section == MEMORY_STR)
+            invalidateMemoryConfig();
+        invalidateIniIndex(edit.path);
+    }
+    iniWriteBuffer.clear();
+    clearDirectoryListingCache();
+}
+
+/**
+ * @brief Queues set-ini-val / remove-ini-key in the write-behind buffer.
+ *
+ * @return false if the command is not buffered; the buffer is flushed first so it can run directly.
+ */
+bool bufferIniCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    const std::string& command = cmd[0];
+    const size_t cmdSize = cmd.size();
+    
+    const bool isSet = (command == "set-ini-val" || command == "set-ini-value") && cmdSize >= 5;
+    const bool isRemove = command == "remove-ini-key" && cmdSize >= 4;
+    if (!isSet && !isRemove) {
+        flushIniWriteBuffer();
+        return false;
+    }
+    
+    BufferedIniEdit edit{cmd[1], cmd[2], cmd[3], {}, isRemove};
+    preprocessPath(edit.path, packagePath);
+    removeQuotes(edit.section);
+    removeQuotes(edit.key);
+    if (isSet) {
+        edit.value = cmd[4];
+        removeQuotes(edit.value);
+    }
+    
+    // Merge into the latest queued edit of this key when it is of the same kind
+    for (auto it = iniWriteBuffer.rbegin(); it != iniWriteBuffer.rend(); ++it) {
+        if (it->path == edit.path && it->section == edit.section && it->key == edit.key) {
+            if (it->remove == edit.remove) {
+                it->value = std::move(edit.value);
+                return true;
+            }
+            break;
+        }
+    }
+    iniWriteBuffer.push_back(std::move(edit));
+    return true;
+}
+
+
+/**
+ * @brief Per-run JSON edit sessions for set-json-key and set-json-val.
+ *
+ * The first edit to a file parses it once. Later edits mutate the same cJSON document, and
+ * flushJsonEditSessions() streams it straight to a temp file (no intermediate cJSON_Print
+ * string) before renaming it over the original. Flushing follows the same rules as the INI
+ * write-behind buffer.
+ *
+ * Edits follow ult::renameJsonKey() and ult::setJsonValue(): a key is renamed in place and
+ * keeps its position, a rename onto an existing key is skipped, and a value is typed as
+ * true/false/null, a number if strtod() consumes all of it, or a string otherwise. A file that
+ * is missing or whose root is not an object is left to the library calls.
+ */
+static std::unordered_map<std::string, cJSON*> jsonEditSessions;  // only touched from the interpreter thread
+
+static void writeJsonString(FILE* fp, const char* str) {
+    fputc('"', fp);
+    for (const unsigned char* c = reinterpret_cast<const unsigned char*>(str ? str : ""); *c; ++c) {
+        switch (*c) {
+            case '"':  fputs("\\\"", fp); break;
+            case '\\': fputs("\\\\", fp); break;
+            case '\b': fputs("\\b", fp); break;
+            case '\f': fputs("\\f", fp); break;
+            case '\n': fputs("\\n", fp); break;
+            case '\r': fputs("\\r", fp); break;
+            case '\t': fputs("\\t", fp); break;
+            default:
+                if (*c < 32)
+                    fprintf(fp, "\\u%04x", *c);
+                else
+                    fputc(*c, fp);
+                break;
+        }
+    }
+    fputc('"', fp);
+}
+
+static void writeJsonNumber(FILE* fp, const cJSON* item) {
+    const double number = item->valuedouble;
+    if (std::isnan(number) || std::isinf(number)) {
+        fputs("null", fp);
+    } else if (number == static_cast<double>(item->valueint)) {
+        fprintf(fp, "%d", item->valueint);
+    } else {
+        // Same precision rules as cJSON_Print
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%1.15g", number);
+        if (strtod(buffer, nullptr) != number)
+            snprintf(buffer, sizeof(buffer), "%1.17g", number);
+        fputs(buffer, fp);
+    }
+}
+
+// Writes a value in the same layout as cJSON_Print (tab indented objects, inline arrays; like
+// print_array, array elements are one level deeper than the array itself)
+static void writeJsonValue(FILE* fp, const cJSON* item, int depth) {
+    if (cJSON_IsObject(item)) {
+        fputs("{\n", fp);
+        for (const cJSON* child = item->child; child; child = child->next) {
+            for (int i = 0; i <= depth; ++i)
+                fputc('\t', fp);
+            writeJsonString(fp, child->string);
+            fputs(":\t", fp);
+            writeJsonValue(fp, child, depth + 1);
+            fputs(child->next ? ",\n" : "\n", fp);
+        }
+        for (int i = 0; i < depth; ++i)
+            fputc('\t', fp);
+        fputc('}', fp);
+    } else if (cJSON_IsArray(item)) {
+        fputc('[', fp);
+        for (const cJSON* child = item->child; child; child = child->next) {
+            writeJsonValue(fp, child, depth + 1);
+            if (child->next)
+                fputs(", ", fp);
+        }
+        fputc(']', fp);
+    } else if (cJSON_IsString(item)) {
+        writeJsonString(fp, item->valuestring);
+    } else if (cJSON_IsNumber(item)) {
+        writeJsonNumber(fp, item);
+    } else if (cJSON_IsRaw(item)) {
+        fputs(item->valuestring ? item->valuestring : "", fp);
+    } else if (cJSON_IsTrue(item)) {
+        fputs("true", fp);
+    } else if (cJSON_IsFalse(item)) {
+        fputs("false", fp);
+    } else {
+        fputs("null", fp);
+    }
+}
+
+/**
+ * @brief Writes every open JSON edit session back to the SD card and frees the documents.
+ */
+void flushJsonEditSessions() {
+    if (jsonEditSessions.empty())
+        return;
+
+    for (auto& [path, root] : jsonEditSessions) {
+        const std::string tempPath = path + ".tmp";
+        createDirectory(getParentDirFromPath(path));
+        FILE* fp = fopen(tempPath.c_str(), "wb");
+        
+        bool writeFailed = !fp;
+        if (fp) {
+            writeJsonValue(fp, root, 0);
+            writeFailed = ferror(fp) != 0;
+            writeFailed = (fclose(fp) != 0) || writeFailed;
+        }
+        cJSON_Delete(root);
+
+        if (writeFailed) {
+            remove(tempPath.c_str());
+            commandSuccess.store(false, std::memory_order_release);
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to write JSON file: " + path);
+            #endif
+            continue;
+        }
+
+        if (!replaceFileWithTemp(tempPath, path))
+            commandSuccess.store(false, std::memory_order_release);
+        invalidateCachedJsonDocument(path);
+        clearDirectoryListingCache();
+    }
+    jsonEditSessions.clear();
+}
+
+// Same typing as ult::setJsonValue()
+static cJSON* createJsonValue(const std::string& value) {
+    if (value == "true")
+        return cJSON_CreateTrue();
+    if (value == "false")
+        return cJSON_CreateFalse();
+    if (value == "null")
+        return cJSON_CreateNull();
+    
+    char* end = nullptr;
+    const double number = strtod(value.c_str(), &end);
+    if (!value.empty() && end && *end == '\0')
+        return cJSON_CreateNumber(number);
+    return cJSON_CreateString(value.c_str());
+}
+
+// Renames an object member without moving it, as ult::renameJsonKey() does
+static void renameJsonMember(cJSON* root, const std::string& oldKey, const std::string& newKey) {
+    cJSON* item = cJSON_GetObjectItemCaseSensitive(root, oldKey.c_str());
+    if (!item || oldKey == newKey || cJSON_GetObjectItemCaseSensitive(root, newKey.c_str()))
+        return;
+    
+    char* name = static_cast<char*>(cJSON_malloc(newKey.size() + 1));
+    if (!name) {
+        commandSuccess.store(false, std::memory_order_release);
+        return;
+    }
+    memcpy(name, newKey.c_str(), newKey.size() + 1);
+    
+    if (!(item->type & cJSON_StringIsConst))
+        cJSON_free(item->string);
+    item->string = name;
+    item->type &= ~cJSON_StringIsConst;
+}
+
+/**
+ * @brief Applies set-json-key or set-json-val to the file's edit session.
+ *
+ * @return false if the command could not be applied in a session (any other command, or a file
+ *         that is missing or whose root is not an object); the sessions are flushed first so it
+ *         can run directly.
+ */
+bool bufferJsonCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    const std::string& command = cmd[0];
+    const size_t cmdSize = cmd.size();
+    
+    const bool renameKey = (command == "set-json-key");
+    if (cmdSize < 4 || !(renameKey || command == "set-json-val" || command == "set-json-value")) {
+        flushJsonEditSessions();
+        return false;
+    }
+    
+    std::string sourcePath = cmd[1];
+    preprocessPath(sourcePath, packagePath);
+    
+    std::string key = cmd[2];
+    removeQuotes(key);
+    
+    std::string value;
+    for (size_t i = 3; i < cmdSize; ++i) {
+        if (i > 3)
+            value += ' ';
+        value += cmd[i];
+    }
+    removeQuotes(value);
+    
+    auto it = jsonEditSessions.find(sourcePath);
+    if (it == jsonEditSessions.end()) {
+        cJSON* root = reinterpret_cast<cJSON*>(readJsonFromFile(sourcePath));
+        if (!root || !cJSON_IsObject(root)) {
+            if (root)
+                cJSON_Delete(root);
+            flushJsonEditSessions();
+            return false;
+        }
+        it = jsonEditSessions.emplace(sourcePath, root).first;
+    }
+    cJSON* root = it->second;
+    
+    if (renameKey) {
+        renameJsonMember(root, key, value);
+        return true;
+    }
+    
+    cJSON* newValue = createJsonValue(value);
+    if (!newValue) {
+        commandSuccess.store(false, std::memory_order_release);
+        return true;
+    }
+    if (cJSON_GetObjectItemCaseSensitive(root, key.c_str()))
+        cJSON_ReplaceItemInObjectCaseSensitive(root, key.c_str(), newValue);
+    else
+        cJSON_AddItemToObject(root, key.c_str(), newValue);
+    return true;
+}
+
+
+/**
+ * @brief Parallel block support (`parallel:` ... `end-parallel:`).
+ *
+ * Independent file operations inside a block are queued and then run together on a small pool
+ * of worker threads. A command that touches a path queued by an earlier command in the block
+ * (or any command that is not parallel-safe) first waits for the queued work to finish, so the
+ * observable order of dependent operations is preserved. A command with placeholders also waits
+ * for the queued work before its placeholders are resolved.
+ *
+ * Inside a `try:` section a block runs sequentially: a failed command must stop the commands
+ * after it, which queued tasks already running on other threads could not honour.
+ *
+ * Parallel-safe are delete, mkdir and plain `cp <source> <destination>`. A queued copy runs on
+ * the in-repo copy engine without reporting to copyPercentage; the block reports its progress by
+ * finished tasks instead. Every task stops on abortFileOp, which they only read, so an abort
+ * stops the whole block. Move, download and unzip go through libultrahand, which drives the
+ * global percentages and abort flags itself, so they always run on the interpreter thread.
+ */
+static constexpr size_t PARALLEL_MAX_WORKERS = 3;
+
+// Aggregated progress of the running parallel block (read by handleRunningInterpreter)
+std::atomic<int> parallelTasksTotal{0};
+std::atomic<int> parallelTasksCompleted{0};
+
+struct ParallelTask {
+    CommandOpcode opcode;
+    std::vector<std::string> cmd;
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+};
+
+struct ParallelRun {
+    std::vector<ParallelTask>* tasks;
+    const std::string* packagePath;
+    const std::string* selectedCommand;
+    std::atomic<size_t> nextTask{0};
+};
+
+// Flag and list forms (-src, -filter, -log_src, ...) touch paths that are not in the positional
+// arguments the overlap check looks at, so they always run in order. Wildcard copies go through
+// libultrahand's copyFileOrDirectoryByPattern and stay on the interpreter thread too.
+inline bool isParallelSafe(CommandOpcode opcode, const std::vector<std::string>& cmd) {
+    switch (opcode) {
+        case CommandOpcode::Delete:
+        case CommandOpcode::MakeDir:
+            break;
+        case CommandOpcode::Copy:
+            if (cmd.size() != 3 || cmd[1].find('*') != std::string::npos)
+                return false;
+            break;
+        default:
+            return false;
+    }
+    for (size_t i = 1; i < cmd.size(); ++i) {
+        if (!cmd[i].empty() && cmd[i][0] == '-')
+            return false;
+    }
+    return true;
+}
+
+// Worker count follows the cores this process may use. The operations are mostly I/O bound,
+// so at least two workers are used unless memory is limited.
+static size_t getParallelWorkerCount() {
+    if (ult::limitedMemory)
+        return 1;
+
+    u64 coreMask = 0;
+    if (R_FAILED(svcGetInfo(&coreMask, InfoType_CoreMask, CUR_PROCESS_HANDLE, 0)))
+        return 2;
+
+    return std::clamp<size_t>(static_cast<size_t>(__builtin_popcountll(coreMask)), 2, PARALLEL_MAX_WORKERS);
+}
+
+// Wildcards are reduced to their literal prefix so overlap checks stay conservative
+static std::string getParallelTaskPath(const std::string& arg, const std::string& packagePath) {
+    std::string path = arg;
+    removeQuotes(path);
+    preprocessPath(path, packagePath);
+    const size_t wildcard = path.find('*');
+    if (wildcard != std::string::npos)
+        path.resize(wildcard);
+    return path;
+}
+
+inline bool parallelPathsOverlap(const std::string& a, const std::string& b) {
+    return a.compare(0, b.size(), b) == 0 || b.compare(0, a.size(), a) == 0;
+}
+
+static void parallelWorker(void* arg) {
+    auto* run = static_cast<ParallelRun*>(arg);
+    const size_t taskCount = run->tasks->size();
+    
+    for (size_t index = run->nextTask.fetch_add(1, std::memory_order_acq_rel); index < taskCount;
+         index = run->nextTask.fetch_add(1, std::memory_order_acq_rel)) {
+        auto& task = (*run->tasks)[index];
+        // Leave abortCommand set so the interpreter loop still sees it
+        if (!abortCommand.load(std::memory_order_acquire)) {
+            if (task.opcode == CommandOpcode::Copy) {
+                // Concurrent copies must not take turns driving copyPercentage
+                handleCopyCommand(task.cmd, *run->packagePath, nullptr);
+                invalidateFileCaches();
+            } else {
+                processCommand(task.opcode, task.cmd, *run->packagePath, *run->selectedCommand);
+            }
+        }
+        task.cmd = {};
+        parallelTasksCompleted.fetch_add(1, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Runs all queued parallel tasks and waits for them to finish.
+ *
+ * The calling thread works through the queue alongside the helper threads.
+ */
+void runParallelTasks(std::vector<ParallelTask>& tasks, const std::string& packagePath, const std::string& selectedCommand) {
+    if (tasks.empty())
+        return;
+
+    parallelTasksCompleted.store(0, std::memory_order_release);
+    parallelTasksTotal.store(static_cast<int>(tasks.size()), std::memory_order_release);
+
+    ParallelRun run{&tasks, &packagePath, &selectedCommand};
+    
+    const size_t helperCount = std::min(tasks.size(), getParallelWorkerCount()) - 1;
+    Thread helpers[PARALLEL_MAX_WORKERS];
+    size_t startedHelpers = 0;
+    
+    for (size_t i = 0; i < helperCount; ++i) {
+        if (R_FAILED(threadCreate(&helpers[startedHelpers], parallelWorker, &run, nullptr, memoryConfigStackSize, 0x2B, -2)))
+            break; // remaining tasks are picked up by the threads that did start
+        if (R_FAILED(threadStart(&helpers[startedHelpers]))) {
+            threadClose(&helpers[startedHelpers]);
+            break;
+        }
+        ++startedHelpers;
+    }
+    
+    parallelWorker(&run);
+    
+    for (size_t i = 0; i < startedHelpers; ++i) {
+        threadWaitForExit(&helpers[i]);
+        threadClose(&helpers[i]);
+    }
+    
+    tasks.clear();
+    parallelTasksTotal.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Queues a command for the current parallel block.
+ *
+ * If the command's paths overlap a path written by a queued command (or it writes a path a
+ * queued command reads), the queued work is run first.
+ */
+void queueParallelTask(std::vector<ParallelTask>& tasks, CommandOpcode opcode, std::vector<std::string>&& cmd,
+                       const std::string& packagePath, const std::string& selectedCommand) {
+    ParallelTask task{opcode, std::move(cmd), {}, {}};
+    const size_t cmdSize = task.cmd.size();
+    
+    switch (opcode) {
+        case CommandOpcode::Copy:
+            if (cmdSize >= 3) {
+                task.reads.push_back(getParallelTaskPath(task.cmd[1], packagePath));
+                task.writes.push_back(getParallelTaskPath(task.cmd[2], packagePath));
+            }
+            break;
+        case CommandOpcode::Delete:
+        case CommandOpcode::MakeDir:
+            if (cmdSize >= 2)
+                task.writes.push_back(getParallelTaskPath(task.cmd[1], packagePath));
+            break;
+        default:
+            break;
+    }
+    
+    bool conflict = false;
+    for (const auto& queued : tasks) {
+        for (const auto& write : task.writes) {
+            for (const auto& path : queued.reads)
+                conflict = conflict || parallelPathsOverlap(write, path);
+            for (const auto& path : queued.writes)
+                conflict = conflict || parallelPathsOverlap(write, path);
+        }
+        for (const auto& read : task.reads) {
+            for (const auto& path : queued.writes)
+                conflict = conflict || parallelPathsOverlap(read, path);
+        }
+        if (conflict)
+            break;
+    }
+    
+    if (conflict)
+        runParallelTasks(tasks, packagePath, selectedCommand);
+    
+    tasks.push_back(std::move(task));
 }
 
 
-
 /**
  * @brief Interpret and execute a list of commands.
  *
@@ -3485,36 +6064,33 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
     }
     #endif
 
-    // Load and apply buffer configuration from INI file
-    const auto bufferSection = getKeyValuePairsFromSection(ULTRAHAND_CONFIG_INI_PATH, MEMORY_STR);
-    
-    if (!bufferSection.empty()) {
-        struct BufferConfig {
-            const char* key;
-            size_t* target;
-        };
-        
-        const BufferConfig configs[] = {
-            {"copy_buffer_size", &COPY_BUFFER_SIZE},
-            {"unzip_read_buffer", &UNZIP_READ_BUFFER},
-            {"unzip_write_buffer", &UNZIP_WRITE_BUFFER},
-            {"download_read_buffer", &DOWNLOAD_READ_BUFFER},
-            {"download_write_buffer", &DOWNLOAD_WRITE_BUFFER},
-            {"hex_buffer_size", &HEX_BUFFER_SIZE}
-        };
-        
-        for (const auto& config : configs) {
-            const auto it = bufferSection.find(config.key);
-            if (it != bufferSection.end()) {
-                *config.target = ult::stoi(it->second);
+    // Apply buffer configuration (only re-parsed after config.ini changes)
+    loadMemoryConfig();
+
+    // Track nesting so per-run state is only reset (and the profile reported) by the outermost run
+    struct RunDepthGuard {
+        const std::string& packagePath;
+        explicit RunDepthGuard(const std::string& path) : packagePath(path) {
+            if (interpreterRunDepth++ == 0) {
+                interpreterProfiling.store(false, std::memory_order_release);
+                // Files may have changed within the same mtime second since the caches were filled
+                clearJsonDocumentCache();
+                clearIniIndexCache();
+                clearHexFileImageCache();
             }
         }
-    }
+        ~RunDepthGuard() {
+            if (--interpreterRunDepth == 0 && interpreterProfiling.exchange(false, std::memory_order_acq_rel))
+                writeCommandProfile((packagePath.empty() ? SETTINGS_PATH : packagePath) + "profile.csv");
+        }
+    } runDepthGuard(packagePath);
 
     // Initialize state variables
     bool inEristaSection = false;
     bool inMarikoSection = false;
     bool inTrySection = false;
+    bool inParallelBlock = false;
+    std::vector<ParallelTask> parallelTasks;
     
     // String buffers for command processing
     std::string listString, listPath, jsonString, jsonPath, hexPath, iniPath;
@@ -3529,12 +6105,18 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
     refreshPackage.store(false, std::memory_order_release);
     interpreterLogging.store(false, std::memory_order_release);
 
+    // Compile (or fetch the cached compilation of) this section once up front
+    const auto compiled = getCompiledSection(commands, packagePath, selectedCommand);
+
     // Process commands one by one, clearing each after processing
     for (size_t i = 0; i < commands.size(); ++i) {
         // Check for abort signal
         if (abortCommand.exchange(false, std::memory_order_acq_rel)) {
             commandSuccess.store(false, std::memory_order_release);
             commands = {};
+            parallelTasks = {};
+            flushIniWriteBuffer();
+            flushJsonEditSessions();
             #if USING_LOGGING_DIRECTIVE
             disableLogging = true;
             logFilePath = defaultLogFilePath;
@@ -3549,13 +6131,18 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
             continue;
         }
 
-        // Use string_view to avoid copying command name
-        const std::string_view commandName = cmd[0];
+        const CompiledCommand& compiledCmd = (*compiled)[i];
+        CommandOpcode opcode = compiledCmd.opcode;
+        const bool hasPlaceholders = commandHasPlaceholders(cmd);
 
         // Handle control flow commands
-        if (commandName == "try:") {
+        if (opcode == CommandOpcode::Try) {
+            // The try check below depends on the outcome of any queued parallel work
+            runParallelTasks(parallelTasks, packagePath, selectedCommand);
             if (inTrySection && commandSuccess.load(std::memory_order_acquire)) {
                 commands = {};
+                flushIniWriteBuffer();
+                flushJsonEditSessions();
                 #if USING_LOGGING_DIRECTIVE
                 disableLogging = true;
                 logFilePath = defaultLogFilePath;
@@ -3569,7 +6156,7 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
             continue;
         }
         
-        if (commandName == "erista:") {
+        if (opcode == CommandOpcode::Erista) {
             inEristaSection = true;
             inMarikoSection = false;
             // Clear and continue
@@ -3577,7 +6164,7 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
             continue;
         }
         
-        if (commandName == "mariko:") {
+        if (opcode == CommandOpcode::Mariko) {
             inEristaSection = false;
             inMarikoSection = true;
             // Clear and continue
@@ -3585,6 +6172,19 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
             continue;
         }
 
+        if (opcode == CommandOpcode::Parallel) {
+            inParallelBlock = true;
+            cmd = {};
+            continue;
+        }
+        
+        if (opcode == CommandOpcode::EndParallel) {
+            runParallelTasks(parallelTasks, packagePath, selectedCommand);
+            inParallelBlock = false;
+            cmd = {};
+            continue;
+        }
+
         // Skip commands in try section if previous command failed
         if (!commandSuccess.load(std::memory_order_acquire) && inTrySection) {
             cmd = {};
@@ -3608,17 +6208,40 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
             continue;
         }
 
-        // Apply placeholder replacements only if needed
-        bool hasPlaceholders = false;
-        for (const auto& arg : cmd) {
-            if (arg.find('{') != std::string::npos) {
-                hasPlaceholders = true;
-                break;
-            }
+        // Buffered INI / JSON edits are written back before anything else can observe the files.
+        // Placeholders in an edit command may read files too.
+        const bool keepEditBuffers = (opcode == CommandOpcode::IniCommand || opcode == CommandOpcode::JsonCommand) &&
+                                     !(hasPlaceholders && readsSourceFile(cmd));
+        if (!keepEditBuffers) {
+            flushIniWriteBuffer();
+            flushJsonEditSessions();
         }
-        
+
+        // Placeholders may read files that queued parallel work has not written yet
+        if (hasPlaceholders) {
+            runParallelTasks(parallelTasks, packagePath, selectedCommand);
+        }
+
+        // Profiling samples (only taken while profiling is enabled)
+        const bool profiling = interpreterProfiling.load(std::memory_order_acquire);
+        u64 profileStartTick = 0, placeholderTicks = 0;
+        s64 heapBefore = 0;
+        if (profiling) {
+            heapBefore = getHeapInUse();
+            profileStartTick = armGetSystemTick();
+        }
+
+        // Apply placeholder replacements only if needed
         if (hasPlaceholders) {
             applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
+            if (profiling) {
+                placeholderTicks = armGetSystemTick() - profileStartTick;
+            }
+
+            // Command name itself was a placeholder, resolve it now
+            if (opcode == CommandOpcode::Dynamic) {
+                opcode = getCommandOpcode(cmd[0]);
+            }
         }
 
         #if USING_LOGGING_DIRECTIVE
@@ -3641,52 +6264,55 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
 
         const size_t cmdSize = cmd.size();
 
-        // Process different command types with direct assignment to reuse string buffers
-        if (commandName == LIST_STR) {
-            if (cmdSize >= 2) {
-                listString = cmd[1]; // Reuses existing string buffer
-                removeQuotes(listString);
-            }
-        } 
-        else if (commandName == LIST_FILE_STR) {
-            if (cmdSize >= 2) {
-                listPath = cmd[1];
-                preprocessPath(listPath, packagePath);
-            }
-        } 
-        else if (commandName == JSON_STR) {
-            if (cmdSize >= 2) {
-                jsonString = cmd[1];
-                removeQuotes(jsonString);  // ADD THIS LINE
-            }
-        } 
-        else if (commandName == JSON_FILE_STR) {
-            if (cmdSize >= 2) {
-                jsonPath = cmd[1];
-                preprocessPath(jsonPath, packagePath);
-            }
-        } 
-        else if (commandName == INI_FILE_STR) {
-            if (cmdSize >= 2) {
-                iniPath = cmd[1];
-                preprocessPath(iniPath, packagePath);
-            }
-        } 
-        else if (commandName == HEX_FILE_STR) {
+        // Source-setting commands use the pre-processed operand unless it had placeholders
+        std::string* sourceTarget = nullptr;
+        switch (opcode) {
+            case CommandOpcode::List:     sourceTarget = &listString; break;
+            case CommandOpcode::ListFile: sourceTarget = &listPath;   break;
+            case CommandOpcode::Json:     sourceTarget = &jsonString; break;
+            case CommandOpcode::JsonFile: sourceTarget = &jsonPath;   break;
+            case CommandOpcode::IniFile:  sourceTarget = &iniPath;    break;
+            case CommandOpcode::HexFile:  sourceTarget = &hexPath;    break;
+            default: break;
+        }
+
+        if (sourceTarget) {
             if (cmdSize >= 2) {
-                hexPath = cmd[1];
-                preprocessPath(hexPath, packagePath);
+                if (compiledCmd.hasOperand)
+                    *sourceTarget = compiledCmd.operand;
+                else
+                    *sourceTarget = compileCommandOperand(opcode, cmd[1], packagePath);
             }
-        } 
-        else {
+        } else if (opcode == CommandOpcode::IniCommand && bufferIniCommand(cmd, packagePath)) {
+            // Queued, run by flushIniWriteBuffer()
+        } else if (opcode == CommandOpcode::JsonCommand && bufferJsonCommand(cmd, packagePath)) {
+            // Applied to the edit session, written back by flushJsonEditSessions()
+        } else if (inParallelBlock && !inTrySection && isParallelSafe(opcode, cmd)) {
+            queueParallelTask(parallelTasks, opcode, std::move(cmd), packagePath, selectedCommand);
+        } else {
+            // Anything that is not parallel-safe waits for queued work first
+            runParallelTasks(parallelTasks, packagePath, selectedCommand);
+            
             // Process all other commands
-            processCommand(cmd, packagePath, selectedCommand);
+            processCommand(opcode, cmd, packagePath, selectedCommand);
+        }
+
+        if (profiling) {
+            recordCommandProfile(cmd.empty() ? std::string() : cmd[0],
+                                 armTicksToNs(armGetSystemTick() - profileStartTick),
+                                 armTicksToNs(placeholderTicks),
+                                 getHeapInUse() - heapBefore);
         }
         
         // Clear the processed command immediately to free its memory
         cmd = {};
     }
 
+    // A block left open at the end of the section still runs
+    runParallelTasks(parallelTasks, packagePath, selectedCommand);
+    flushIniWriteBuffer();
+    flushJsonEditSessions();
+
     // Final cleanup
     commands = {};
 
@@ -3699,6 +6325,10 @@ bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& command
 }
 
 
+inline bool hasCommandFlag(const std::vector<std::string>& cmd, std::string_view flag) {
+    return std::find(cmd.begin() + 1, cmd.end(), flag) != cmd.end();
+}
+
 // Helper function to parse command arguments
 void parseCommandArguments(const std::vector<std::string>& cmd, const std::string& packagePath, std::string& sourceListPath, std::string& destinationListPath, std::string& logSource, std::string& logDestination, std::string& sourcePath, std::string& destinationPath, std::string& copyFilterListPath, std::string& filterListPath) {
     for (size_t i = 1; i < cmd.size(); ++i) {
@@ -3720,6 +6350,8 @@ void parseCommandArguments(const std::vector<std::string>& cmd, const std::strin
         } else if (cmd[i] == "-filter" && i + 1 < cmd.size()) {
             filterListPath = cmd[++i];
             preprocessPath(filterListPath, packagePath);
+        } else if (cmd[i] == "-sort" || cmd[i] == "-skip_identical") {
+            // Flags without a value, read by hasCommandFlag()
         } else if (sourcePath.empty()) {
             sourcePath = cmd[i];
             preprocessPath(sourcePath, packagePath);
@@ -3739,42 +6371,650 @@ void handleMakeDirCommand(const std::vector<std::string>& cmd, const std::string
     }
 }
 
-void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+/**
+ * @brief Copy engine that overlaps SD reads with writes.
+ *
+ * Files of at least two buffers are copied by a reader thread that fills up to
+ * COPY_PIPELINE_DEPTH buffers of COPY_BUFFER_SIZE while the calling thread writes the previous
+ * ones, so read and write latency overlap. The reader blocks while every buffer is full and the
+ * writer blocks while none is ready. Smaller files, and all files under limited memory, use a
+ * single buffer. Progress goes to the caller's CopyProgress and abortFileOp stops the copy.
+ *
+ * The reader thread and its buffers are started by the first large file and then wait for the
+ * next one, so a manifest copy creates one thread however many large files it holds.
+ */
+static constexpr size_t COPY_PIPELINE_DEPTH = 3;
+static constexpr size_t COPY_READER_STACK_SIZE = 0x4000;
+
+struct CopyPipeline {
+    FILE* source = nullptr;  // file being read, nullptr while the reader is idle
+    size_t bufferSize = 0;
+    std::vector<u8> buffers[COPY_PIPELINE_DEPTH];
+    size_t lengths[COPY_PIPELINE_DEPTH] = {};
+    size_t ready = 0;        // filled buffers waiting to be written
+    size_t readSlot = 0;
+    bool readDone = false;
+    bool readFailed = false;
+    bool reading = false;    // the reader is inside fread() on source
+    bool cancelled = false;  // set by the writer on abort or write failure
+    bool exit = false;       // set when the pipeline shuts down
+    bool running = false;
+    Thread reader;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    bool start(size_t size);
+    void shutdown();
+
+    ~CopyPipeline() {
+        shutdown();
+    }
+};
+
+static void copyPipelineReader(void* arg) {
+    CopyPipeline& pipeline = *static_cast<CopyPipeline*>(arg);
+
+    for (;;) {
+        size_t slot;
+        FILE* source;
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.changed.wait(lock, [&] {
+                return pipeline.exit || (pipeline.source && !pipeline.readDone && !pipeline.cancelled &&
+                                         pipeline.ready < COPY_PIPELINE_DEPTH);
+            });
+            if (pipeline.exit)
+                break;
+            slot = pipeline.readSlot;
+            source = pipeline.source;
+            pipeline.reading = true;
+        }
+
+        // The slot is not handed to the writer until ready is raised, so it is read unlocked
+        const size_t bytesRead = fread(pipeline.buffers[slot].data(), 1, pipeline.bufferSize, source);
+
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.reading = false;
+        if (bytesRead == 0) {
+            pipeline.readDone = true;
+            pipeline.readFailed = ferror(source) != 0;
+        } else {
+            pipeline.lengths[slot] = bytesRead;
+            pipeline.readSlot = (slot + 1) % COPY_PIPELINE_DEPTH;
+            ++pipeline.ready;
+        }
+        pipeline.changed.notify_all();
+    }
+}
+
+bool CopyPipeline::start(size_t size) {
+    if (running)
+        return bufferSize == size;
+
+    bufferSize = size;
+    for (auto& buffer : buffers)
+        buffer.resize(size);
+    exit = false;
+
+    if (R_FAILED(threadCreate(&reader, copyPipelineReader, this, nullptr, COPY_READER_STACK_SIZE, 0x2B, -2)))
+        return false;
+    if (R_FAILED(threadStart(&reader))) {
+        threadClose(&reader);
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+void CopyPipeline::shutdown() {
+    if (!running)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exit = true;
+        changed.notify_all();
+    }
+    threadWaitForExit(&reader);
+    threadClose(&reader);
+    running = false;
+}
+
+/**
+ * @brief Bytes copied so far out of a copy's total, and the percentage they are reported to.
+ *
+ * Interpreter copies report to copyPercentage; copies queued in a parallel block pass nullptr,
+ * since several of them run at once and the block reports by finished tasks.
+ */
+struct CopyProgress {
+    std::atomic<int>* percentage = &copyPercentage;
+    long long copied = 0;
+    long long total = 0;
+};
+
+static inline void addCopyProgress(CopyProgress* progress, size_t bytes) {
+    if (!progress)
+        return;
+    progress->copied += static_cast<long long>(bytes);
+    if (progress->percentage && progress->total > 0)
+        progress->percentage->store(static_cast<int>(std::min<long long>(100, progress->copied * 100 / progress->total)), std::memory_order_release);
+}
+
+static bool copyStreamSequential(FILE* source, FILE* destination, size_t bufferSize, CopyProgress* progress) {
+    std::vector<u8> buffer(bufferSize);
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer.data(), 1, bufferSize, source)) > 0) {
+        if (abortFileOp.load(std::memory_order_acquire) || fwrite(buffer.data(), 1, bytesRead, destination) != bytesRead)
+            return false;
+        addCopyProgress(progress, bytesRead);
+    }
+    return ferror(source) == 0;
+}
+
+static bool copyStreamPipelined(CopyPipeline& pipeline, FILE* source, FILE* destination, CopyProgress* progress) {
+    {
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.source = source;
+        pipeline.ready = 0;
+        pipeline.readSlot = 0;
+        pipeline.readDone = false;
+        pipeline.readFailed = false;
+        pipeline.cancelled = false;
+        pipeline.changed.notify_all();
+    }
+
+    bool success = true;
+    size_t writeSlot = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.changed.wait(lock, [&] { return pipeline.ready > 0 || pipeline.readDone; });
+            if (pipeline.ready == 0) {
+                success = !pipeline.readFailed;
+                break;
+            }
+        }
+
+        const size_t length = pipeline.lengths[writeSlot];
+        if (abortFileOp.load(std::memory_order_acquire) ||
+            fwrite(pipeline.buffers[writeSlot].data(), 1, length, destination) != length) {
+            success = false;
+            break;
+        }
+        addCopyProgress(progress, length);
+        writeSlot = (writeSlot + 1) % COPY_PIPELINE_DEPTH;
+
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        --pipeline.ready;
+        pipeline.changed.notify_all();
+    }
+
+    // The caller closes source next, so wait for a read still in progress on it
+    std::unique_lock<std::mutex> lock(pipeline.mutex);
+    pipeline.cancelled = true;
+    pipeline.changed.wait(lock, [&] { return !pipeline.reading; });
+    pipeline.source = nullptr;
+    return success;
+}
+
+/**
+ * @brief Checks whether an existing destination already holds the same bytes as the source.
+ *
+ * Sizes are compared first; only files of equal size are read, a chunk of each at a time, and
+ * the comparison stops at the first chunk whose bytes differ.
+ */
+bool filesHaveSameContent(const std::string& fromFile, const std::string& toFile, long long size) {
+    struct stat st;
+    if (stat(toFile.c_str(), &st) != 0 || S_ISDIR(st.st_mode) || static_cast<long long>(st.st_size) != size)
+        return false;
+
+    FILE* source = fopen(fromFile.c_str(), "rb");
+    if (!source)
+        return false;
+    FILE* destination = fopen(toFile.c_str(), "rb");
+    if (!destination) {
+        fclose(source);
+        return false;
+    }
+
+    static constexpr size_t CHUNK_SIZE = 0x8000;
+    std::unique_ptr<u8[]> buffer(new u8[2 * CHUNK_SIZE]);
+    u8* sourceChunk = buffer.get();
+    u8* destinationChunk = buffer.get() + CHUNK_SIZE;
+
+    bool identical = true;
+    for (;;) {
+        const size_t sourceRead = fread(sourceChunk, 1, CHUNK_SIZE, source);
+        const size_t destinationRead = fread(destinationChunk, 1, CHUNK_SIZE, destination);
+        if (sourceRead != destinationRead || abortFileOp.load(std::memory_order_acquire)) {
+            identical = false;
+            break;
+        }
+        if (sourceRead == 0)
+            break;
+
+        if (std::memcmp(sourceChunk, destinationChunk, sourceRead) != 0) {
+            identical = false;
+            break;
+        }
+    }
+
+    identical = identical && !ferror(source) && !ferror(destination);
+    fclose(source);
+    fclose(destination);
+    return identical;
+}
+
+/**
+ * @brief Copies one file, creating the destination's parent directories.
+ *
+ * A failed or aborted copy removes the partial destination file. Large files are read through
+ * pipeline when one is given (started on first use), or through a pipeline of their own.
+ */
+bool copyFileBuffered(const std::string& fromFile, const std::string& toFile, CopyProgress* progress = nullptr,
+                      CopyPipeline* pipeline = nullptr) {
+    FILE* source = fopen(fromFile.c_str(), "rb");
+    if (!source)
+        return false;
+
+    createDirectory(getParentDirFromPath(toFile));
+    FILE* destination = fopen(toFile.c_str(), "wb");
+    if (!destination) {
+        fclose(source);
+        return false;
+    }
+
+    const size_t bufferSize = COPY_BUFFER_SIZE ? COPY_BUFFER_SIZE : 0x10000;
+    struct stat st;
+    const long long fileSize = (fstat(fileno(source), &st) == 0) ? static_cast<long long>(st.st_size) : 0;
+
+    bool success;
+    if (!ult::limitedMemory && fileSize >= static_cast<long long>(2 * bufferSize)) {
+        std::unique_ptr<CopyPipeline> ownPipeline;
+        if (!pipeline) {
+            ownPipeline = std::make_unique<CopyPipeline>();
+            pipeline = ownPipeline.get();
+        }
+        if (pipeline->start(bufferSize))
+            success = copyStreamPipelined(*pipeline, source, destination, progress);
+        else
+            success = copyStreamSequential(source, destination, bufferSize, progress);
+    } else {
+        success = copyStreamSequential(source, destination, bufferSize, progress);
+    }
+
+    fclose(source);
+    success = (fclose(destination) == 0) && success;
+    if (!success) {
+        remove(toFile.c_str());
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging && !abortFileOp.load(std::memory_order_acquire))
+            logMessage("Failed to copy " + fromFile + " to " + toFile);
+        #endif
+    }
+    return success;
+}
+
+static void appendCopyLog(FILE* log, const std::string& path) {
+    if (log) {
+        fwrite(path.data(), 1, path.size(), log);
+        fputc('\n', log);
+    }
+}
+
+/**
+ * @brief Everything one copy command will transfer, gathered in a single walk.
+ *
+ * Each planned source/destination pair is a root; every file and directory below it is stored
+ * as a path relative to its root in one string arena, with the file size read during the walk.
+ * The copy then runs from the manifest with exact byte progress, without walking the tree again.
+ */
+struct CopyManifest {
+    struct Root {
+        std::string source;
+        std::string destination;
+    };
+    struct Entry {
+        u32 root;
+        u32 pathOffset;   // relative path in the arena
+        u32 pathLength;
+        bool isDirectory;
+        long long size;
+        s64 mtime;
+    };
+
+    std::vector<Root> roots;
+    std::vector<Entry> entries;
+    std::string arena;
+    long long totalSize = 0;
+    bool skipIdentical = false;   // leave destination files that already match untouched (-skip_identical)
+
+    std::string_view relativePath(const Entry& entry) const {
+        return std::string_view(arena).substr(entry.pathOffset, entry.pathLength);
+    }
+
+    void add(u32 root, std::string_view relative, bool isDirectory, long long size, s64 mtime = 0) {
+        entries.push_back({root, static_cast<u32>(arena.size()), static_cast<u32>(relative.size()), isDirectory, size, mtime});
+        arena.append(relative);
+        totalSize += size;
+    }
+};
+
+/**
+ * @brief Adds a copy of fromPath to toPath to the manifest.
+ *
+ * A source file is copied to the destination path, or into it if the destination ends in '/'.
+ * A source directory (ending in '/') has its contents copied into the destination directory.
+ * As in copyFileOrDirectory(), a directory given without its trailing '/' is not copied.
+ *
+ * @return false if the source does not exist or the copy is not possible.
+ */
+bool planCopy(CopyManifest& manifest, const std::string& fromPath, const std::string& toPath) {
+    if (fromPath.empty() || toPath.empty())
+        return false;
+
+    struct stat st;
+    if (fromPath.back() != '/') {
+        if (stat(fromPath.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+            return false;
+        const std::string toFile = (toPath.back() == '/') ? toPath + getNameFromPath(fromPath) : toPath;
+        if (toFile == fromPath)
+            return false;
+
+        manifest.roots.push_back({fromPath, toFile});
+        manifest.add(static_cast<u32>(manifest.roots.size() - 1), std::string_view(), false,
+                     static_cast<long long>(st.st_size), static_cast<s64>(st.st_mtime));
+        return true;
+    }
+
+    const std::string toDirectory = (toPath.back() == '/') ? toPath : toPath + '/';
+
+    // Copying a directory into itself would never finish
+    if (toDirectory.compare(0, fromPath.size(), fromPath) == 0) {
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging)
+            logMessage("Cannot copy a directory into itself: " + fromPath);
+        #endif
+        return false;
+    }
+
+    DIR* dir = opendir(fromPath.c_str());
+    if (!dir)
+        return false;
+
+    manifest.roots.push_back({fromPath, toDirectory});
+    const u32 root = static_cast<u32>(manifest.roots.size() - 1);
+    manifest.add(root, std::string_view(), true, 0);
+
+    // Relative directories still to walk; dir is the open handle for the first one
+    std::vector<std::string> pending;
+    std::string relativeDirectory;
+    std::string fullPath;
+
+    for (;;) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            const std::string_view name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+
+            std::string relative = relativeDirectory;
+            relative += name;
+            fullPath = fromPath;
+            fullPath += relative;
+
+            // Files need a stat for their size anyway; directories are known from d_type
+            if (entry->d_type == DT_DIR) {
+                relative += '/';
+                manifest.add(root, relative, true, 0);
+                pending.push_back(std::move(relative));
+            } else if (stat(fullPath.c_str(), &st) == 0) {
+                if (S_ISDIR(st.st_mode)) {
+                    relative += '/';
+                    manifest.add(root, relative, true, 0);
+                    pending.push_back(std::move(relative));
+                } else {
+                    manifest.add(root, relative, false, static_cast<long long>(st.st_size), static_cast<s64>(st.st_mtime));
+                }
+            }
+        }
+        closedir(dir);
+
+        dir = nullptr;
+        while (!dir && !pending.empty()) {
+            relativeDirectory = std::move(pending.back());
+            pending.pop_back();
+            dir = opendir((fromPath + relativeDirectory).c_str());
+        }
+        if (!dir)
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief Copies everything in the manifest, reporting progress across the whole manifest.
+ *
+ * Copied source and destination file paths are appended to logSource / logDestination.
+ * The percentage (copyPercentage unless given, none if nullptr) is left at 100 after a complete
+ * copy and at -1 after a failed or aborted one.
+ *
+ * @return true if every entry was copied.
+ */
+bool copyFromManifest(const CopyManifest& manifest, const std::string& logSource = "", const std::string& logDestination = "",
+                      std::atomic<int>* percentage = &copyPercentage) {
+    FILE* sourceLog = logSource.empty() ? nullptr : fopen(logSource.c_str(), "a");
+    FILE* destinationLog = logDestination.empty() ? nullptr : fopen(logDestination.c_str(), "a");
+
+    CopyProgress progress{percentage, 0, manifest.totalSize};
+    CopyPipeline pipeline;  // one reader thread for every large file in the manifest
+    std::string from, to;
+    bool success = true;
+
+    for (const auto& entry : manifest.entries) {
+        if (abortFileOp.load(std::memory_order_acquire)) {
+            success = false;
+            break;
+        }
+
+        const CopyManifest::Root& root = manifest.roots[entry.root];
+        const std::string_view relative = manifest.relativePath(entry);
+        to.assign(root.destination).append(relative);
+
+        if (entry.isDirectory) {
+            createDirectory(to);
+            continue;
+        }
+
+        from.assign(root.source).append(relative);
+        if (manifest.skipIdentical && filesHaveSameContent(from, to, entry.size)) {
+            addCopyProgress(&progress, static_cast<size_t>(entry.size));
+            continue;
+        }
+        if (copyFileBuffered(from, to, &progress, &pipeline)) {
+            appendCopyLog(sourceLog, from);
+            appendCopyLog(destinationLog, to);
+        } else {
+            success = false;
+        }
+    }
+
+    if (sourceLog)
+        fclose(sourceLog);
+    if (destinationLog)
+        fclose(destinationLog);
+    if (percentage)
+        percentage->store(success ? 100 : -1, std::memory_order_release);
+    return success;
+}
+
+// Directory whose entries change when path is created or moved (its parent, for directories)
+static std::string_view getEntryDirectory(std::string_view path) {
+    if (!path.empty() && path.back() == '/')
+        path.remove_suffix(1);
+    const size_t slash = path.rfind('/');
+    return (slash == std::string_view::npos) ? std::string_view() : path.substr(0, slash + 1);
+}
+
+/**
+ * @brief Paths planned by a list copy or move, to find later pairs that depend on them.
+ *
+ * Two paths overlap if they are equal or one lies inside the other. Each path is kept without
+ * its trailing '/', and every parent directory of it is kept as well, so both directions are
+ * set lookups.
+ */
+struct PlannedPathSet {
+    std::unordered_set<std::string> paths;
+    std::unordered_set<std::string> parents;
+
+    void insert(std::string path) {
+        if (!path.empty() && path.back() == '/')
+            path.pop_back();
+        paths.insert(path);
+        for (size_t slash = path.rfind('/'); slash != std::string::npos; slash = path.rfind('/')) {
+            path.resize(slash);
+            if (!parents.insert(path).second)
+                break;   // its parents are already recorded
+        }
+    }
+
+    bool overlaps(std::string path) const {
+        if (paths.empty())
+            return false;
+        if (!path.empty() && path.back() == '/')
+            path.pop_back();
+        if (parents.count(path))
+            return true;
+        for (;;) {
+            if (paths.count(path))
+                return true;
+            const size_t slash = path.rfind('/');
+            if (slash == std::string::npos)
+                return false;
+            path.resize(slash);
+        }
+    }
+
+    void clear() {
+        paths.clear();
+        parents.clear();
+    }
+};
+
+/**
+ * @brief Reorders a manifest so entries going to the same destination directory are adjacent.
+ *
+ * FAT updates a directory's entry table for every file created in it, so grouping writes by
+ * directory keeps those updates together. Directories keep their place ahead of their contents.
+ */
+void sortCopyManifestByDestination(CopyManifest& manifest) {
+    std::vector<std::pair<std::string, u32>> keys;
+    keys.reserve(manifest.entries.size());
+
+    std::string destination;
+    for (size_t i = 0; i < manifest.entries.size(); ++i) {
+        const CopyManifest::Entry& entry = manifest.entries[i];
+        destination.assign(manifest.roots[entry.root].destination).append(manifest.relativePath(entry));
+        keys.emplace_back(entry.isDirectory ? destination : std::string(getEntryDirectory(destination)), static_cast<u32>(i));
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<CopyManifest::Entry> sorted;
+    sorted.reserve(manifest.entries.size());
+    for (const auto& key : keys)
+        sorted.push_back(manifest.entries[key.second]);
+    manifest.entries.swap(sorted);
+}
+
+/**
+ * @brief copyFileOrDirectory() on top of a single-walk CopyManifest and copyFileBuffered().
+ */
+void copyFileOrDirectoryBuffered(const std::string& fromPath, const std::string& toPath,
+                                 const std::string& logSource = "", const std::string& logDestination = "",
+                                 bool skipIdentical = false, std::atomic<int>* percentage = &copyPercentage) {
+    CopyManifest manifest;
+    manifest.skipIdentical = skipIdentical;
+    if (planCopy(manifest, fromPath, toPath))
+        copyFromManifest(manifest, logSource, logDestination, percentage);
+}
+
+/**
+ * @brief copyFileOrDirectoryByPattern() on top of one CopyManifest for all wildcard matches.
+ */
+void copyFileOrDirectoryByPatternBuffered(const std::string& sourcePattern, const std::string& toPath,
+                                          const std::string& logSource, const std::string& logDestination,
+                                          const std::unordered_set<std::string>* filterSet, bool skipIdentical,
+                                          std::atomic<int>* percentage = &copyPercentage) {
+    CopyManifest manifest;
+    manifest.skipIdentical = skipIdentical;
+    for (const auto& sourcePath : getCachedFilesListByWildcards(sourcePattern)) {
+        if (abortFileOp.load(std::memory_order_acquire))
+            return;
+        if (!filterSet || filterSet->find(sourcePath) == filterSet->end())
+            planCopy(manifest, sourcePath, toPath);
+    }
+    copyFromManifest(manifest, logSource, logDestination, percentage);
+}
+
+
+void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& packagePath, std::atomic<int>* percentage = &copyPercentage) {
     // Declare only the strings we always need
     std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
     parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
+    const bool skipIdentical = hasCommandFlag(cmd, "-skip_identical");
     
     if (!sourceListPath.empty() && !destinationListPath.empty()) {
-        // Process list-based copying
-        auto sourceFilesList = readListFromFile(sourceListPath);
-        auto destinationFilesList = readListFromFile(destinationListPath);
-        
         // Only create filterSet if filter file exists
         std::unique_ptr<std::unordered_set<std::string>> filterSet;
         if (!filterListPath.empty()) {
             filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath, packagePath));
         }
         
-        const size_t listSize = std::min(sourceFilesList.size(), destinationFilesList.size());
-        for (size_t i = 0; i < listSize; ++i) {
-            // Reuse existing sourcePath and destinationPath strings
-            sourcePath = std::move(sourceFilesList[i]);
-            sourceFilesList[i].shrink_to_fit();     // Free the capacity
+        // One manifest for the whole list, so the tree is walked once and progress covers every entry
+        CopyManifest manifest;
+        manifest.skipIdentical = skipIdentical;
+        const bool sortByDestination = hasCommandFlag(cmd, "-sort");
+        
+        // A pair that reads what an earlier pair writes runs the planned manifest first, so it sees
+        // that copy done. With -sort the writes are reordered too, so a pair that writes what an
+        // earlier pair reads must not join the same manifest either.
+        PlannedPathSet plannedSources, plannedDestinations;
+        const auto copyPlanned = [&]() {
+            if (sortByDestination) {
+                sortCopyManifestByDestination(manifest);
+            }
+            copyFromManifest(manifest, "", "", percentage);
+            manifest = CopyManifest();
+            manifest.skipIdentical = skipIdentical;
+            plannedSources.clear();
+            plannedDestinations.clear();
+        };
+        
+        forEachListFilePair(sourceListPath, destinationListPath, [&](const std::string& source, const std::string& destination) {
+            sourcePath = source;
             preprocessPath(sourcePath, packagePath);
-            
-            destinationPath = std::move(destinationFilesList[i]);
-            destinationFilesList[i].shrink_to_fit(); // Free the capacity
+            destinationPath = destination;
             preprocessPath(destinationPath, packagePath);
             
             // Only check filter if it exists
-            const bool shouldCopy = !filterSet || filterSet->find(sourcePath) == filterSet->end();
-            
-            if (shouldCopy) {
-                const long long totalSize = getTotalSize(sourcePath);
-                long long totalBytesCopied = 0;
-                copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+            if (!filterSet || filterSet->find(sourcePath) == filterSet->end()) {
+                if (plannedDestinations.overlaps(sourcePath) ||
+                    (sortByDestination && plannedSources.overlaps(destinationPath))) {
+                    copyPlanned();
+                }
+                
+                const size_t firstRoot = manifest.roots.size();
+                planCopy(manifest, sourcePath, destinationPath);
+                for (size_t i = firstRoot; i < manifest.roots.size(); ++i) {
+                    plannedDestinations.insert(manifest.roots[i].destination);
+                    if (sortByDestination)
+                        plannedSources.insert(manifest.roots[i].source);
+                }
             }
-        }
+            return !abortFileOp.load(std::memory_order_acquire);
+        });
+        
+        copyPlanned();
         
     } else {
         // Single file/directory copying - early returns to avoid unnecessary work
@@ -3799,11 +7039,14 @@ void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& p
             if (!filterListPath.empty()) {
                 filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath, packagePath));
             }
-            copyFileOrDirectoryByPattern(sourcePath, destinationPath, logSource, logDestination, filterSet.get());
+            // Wildcard copies stay on the library unless -skip_identical needs the in-repo engine
+            if (skipIdentical) {
+                copyFileOrDirectoryByPatternBuffered(sourcePath, destinationPath, logSource, logDestination, filterSet.get(), true, percentage);
+            } else {
+                copyFileOrDirectoryByPattern(sourcePath, destinationPath, logSource, logDestination, filterSet.get());
+            }
         } else {
-            const long long totalSize = getTotalSize(sourcePath);
-            long long totalBytesCopied = 0;
-            copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize, logSource, logDestination);
+            copyFileOrDirectoryBuffered(sourcePath, destinationPath, logSource, logDestination, skipIdentical, percentage);
         }
     }
 }
@@ -3814,19 +7057,15 @@ void handleDeleteCommand(const std::vector<std::string>& cmd, const std::string&
     parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
     
     if (!sourceListPath.empty()) {
-        // Process list-based deletion
-        auto sourceFilesList = readListFromFile(sourceListPath);
-        
         // Only create filterSet if filter file exists
         std::unique_ptr<std::unordered_set<std::string>> filterSet;
         if (!filterListPath.empty()) {
             filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath, packagePath));
         }
         
-        for (size_t i = 0; i < sourceFilesList.size(); ++i) {
-            // Move string to avoid copy
-            sourcePath = std::move(sourceFilesList[i]);
-            sourceFilesList[i].shrink_to_fit();     // Free the capacity
+        // Process list-based deletion, streaming the list instead of loading it whole
+        forEachListFileLine(sourceListPath, 0, [&](const std::string& line) {
+            sourcePath = line;
             preprocessPath(sourcePath, packagePath);
             
             // Only check filter if it exists
@@ -3835,7 +7074,8 @@ void handleDeleteCommand(const std::vector<std::string>& cmd, const std::string&
             if (shouldDelete) {
                 deleteFileOrDirectory(sourcePath, logSource);
             }
-        }
+            return !abortFileOp.load(std::memory_order_acquire);
+        });
         
     } else {
         // Single file/directory deletion - early returns for error conditions
@@ -3870,6 +7110,243 @@ void handleDeleteCommand(const std::vector<std::string>& cmd, const std::string&
 }
 
 
+/**
+ * @brief Record of what the last mirror_copy put in place, so re-runs only apply the difference.
+ *
+ * After a complete mirror_copy the relative path of every file is written under
+ * `sdmc:/config/ultrahand/cache/`, named after a hash of the source and destination, with the size
+ * and mtime of both the source file and the copy made of it. The next mirror_copy of the same pair
+ * copies only files whose source or destination no longer matches the record. Like mirrorFiles(),
+ * it leaves destination copies of files removed from the source in place; with -delete_removed
+ * it deletes them, but only while they are still the copies it made.
+ *
+ * mirror_delete drops the record on purpose: it removes the destination copies, so the next
+ * mirror_copy has to copy every file again and a kept record could not save any of it.
+ *
+ * Layout (native endian):
+ *   MirrorManifestHeader
+ *   per file: u64 size, s64 mtime, u64 destinationSize, s64 destinationMtime, u32 pathLen, path bytes
+ */
+static constexpr u32 MIRROR_MANIFEST_MAGIC = 0x4D4D4855; // "UHMM"
+static constexpr u32 MIRROR_MANIFEST_VERSION = 2;
+
+struct MirrorManifestHeader {
+    u32 magic;
+    u32 version;
+    u32 fileCount;
+    u32 payloadSize;
+};
+
+struct MirroredFile {
+    u64 size;
+    s64 mtime;
+    u64 destinationSize;
+    s64 destinationMtime;
+
+    bool destinationMatches(const struct stat& st) const {
+        return static_cast<u64>(st.st_size) == destinationSize && static_cast<s64>(st.st_mtime) == destinationMtime;
+    }
+};
+
+inline std::string getMirrorManifestPath(const std::string& sourceDirectory, const std::string& destinationDirectory) {
+    char name[32];
+    snprintf(name, sizeof(name), "mirror_%016llx.bin",
+             static_cast<unsigned long long>(std::hash<std::string>{}(sourceDirectory + '\n' + destinationDirectory)));
+    return SETTINGS_PATH + "cache/" + name;
+}
+
+bool readMirrorManifest(const std::string& manifestPath, std::unordered_map<std::string, MirroredFile>& files) {
+    FILE* file = fopen(manifestPath.c_str(), "rb");
+    if (!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    const long fileSize = ftell(file);
+    if (fileSize < static_cast<long>(sizeof(MirrorManifestHeader))) {
+        fclose(file);
+        return false;
+    }
+    fseek(file, 0, SEEK_SET);
+
+    // One read for the whole manifest
+    std::string data(static_cast<size_t>(fileSize), '\0');
+    const bool readOk = fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    if (!readOk) return false;
+
+    MirrorManifestHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MIRROR_MANIFEST_MAGIC || header.version != MIRROR_MANIFEST_VERSION ||
+        header.payloadSize != data.size() - sizeof(header)) {
+        return false;
+    }
+
+    const char* cursor = data.data() + sizeof(header);
+    const char* end = data.data() + data.size();
+
+    files.clear();
+    files.reserve(header.fileCount);
+
+    MirroredFile mirrored;
+    std::string path;
+    for (u32 i = 0; i < header.fileCount; ++i) {
+        if (static_cast<size_t>(end - cursor) < sizeof(mirrored.size) + sizeof(mirrored.mtime) +
+                                                sizeof(mirrored.destinationSize) + sizeof(mirrored.destinationMtime)) {
+            files.clear();
+            return false;
+        }
+        std::memcpy(&mirrored.size, cursor, sizeof(mirrored.size));
+        cursor += sizeof(mirrored.size);
+        std::memcpy(&mirrored.mtime, cursor, sizeof(mirrored.mtime));
+        cursor += sizeof(mirrored.mtime);
+        std::memcpy(&mirrored.destinationSize, cursor, sizeof(mirrored.destinationSize));
+        cursor += sizeof(mirrored.destinationSize);
+        std::memcpy(&mirrored.destinationMtime, cursor, sizeof(mirrored.destinationMtime));
+        cursor += sizeof(mirrored.destinationMtime);
+
+        if (!readCacheString(cursor, end, path)) {
+            files.clear();
+            return false;
+        }
+        files.emplace(std::move(path), mirrored);
+    }
+    return cursor == end;
+}
+
+/**
+ * @brief Records a completed mirror_copy, reading each copy's size and mtime from the destination.
+ *
+ * Files whose copy cannot be found are left out, so the next run copies them again.
+ */
+void writeMirrorManifest(const std::string& manifestPath, const CopyManifest& manifest, const std::string& destinationDirectory) {
+    std::string payload;
+    u32 fileCount = 0;
+    struct stat st;
+    std::string destination;
+    for (const auto& entry : manifest.entries) {
+        if (entry.isDirectory)
+            continue;
+        const std::string_view relative = manifest.relativePath(entry);
+        destination.assign(destinationDirectory).append(relative);
+        if (stat(destination.c_str(), &st) != 0)
+            continue;
+
+        const u64 size = static_cast<u64>(entry.size);
+        const u64 destinationSize = static_cast<u64>(st.st_size);
+        const s64 destinationMtime = static_cast<s64>(st.st_mtime);
+        payload.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        payload.append(reinterpret_cast<const char*>(&entry.mtime), sizeof(entry.mtime));
+        payload.append(reinterpret_cast<const char*>(&destinationSize), sizeof(destinationSize));
+        payload.append(reinterpret_cast<const char*>(&destinationMtime), sizeof(destinationMtime));
+        appendCacheString(payload, std::string(relative));
+        ++fileCount;
+    }
+
+    const MirrorManifestHeader header = {
+        MIRROR_MANIFEST_MAGIC,
+        MIRROR_MANIFEST_VERSION,
+        fileCount,
+        static_cast<u32>(payload.size())
+    };
+
+    createDirectory(getParentDirFromPath(manifestPath));
+
+    // Write to a temp file first so a partial write never looks like a valid manifest
+    const std::string tempPath = manifestPath + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return;
+
+    const bool writeOk = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                         fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    fclose(file);
+
+    if (!writeOk) {
+        remove(tempPath.c_str());
+        return;
+    }
+    // A record that could not be replaced is still safe to keep: copies made since then no
+    // longer match its destination sizes and mtimes, so they are neither skipped nor deleted
+    replaceFileWithTemp(tempPath, manifestPath);
+}
+
+/**
+ * @brief mirrorFiles() that applies only what changed since the last mirror_copy of the same pair.
+ *
+ * @param operation "copy" or "delete", as for mirrorFiles().
+ * @param deleteRemoved For "copy", also delete the copies of files removed from the source since the last run.
+ */
+void mirrorFilesIncremental(const std::string& sourcePath, const std::string& destinationPath, const std::string& operation,
+                            bool deleteRemoved = false) {
+    const std::string sourceDirectory = (!sourcePath.empty() && sourcePath.back() == '/') ? sourcePath : sourcePath + '/';
+    const std::string destinationDirectory = (!destinationPath.empty() && destinationPath.back() == '/') ? destinationPath : destinationPath + '/';
+    const std::string manifestPath = getMirrorManifestPath(sourceDirectory, destinationDirectory);
+
+    if (operation != "copy") {
+        mirrorFiles(sourcePath, destinationPath, operation);
+        remove(manifestPath.c_str());
+        return;
+    }
+
+    CopyManifest current;
+    if (!planCopy(current, sourceDirectory, destinationDirectory)) {
+        mirrorFiles(sourcePath, destinationPath, operation);
+        return;
+    }
+
+    std::unordered_map<std::string, MirroredFile> previous;
+    readMirrorManifest(manifestPath, previous);
+
+    CopyManifest changed;
+    changed.roots = current.roots;
+
+    struct stat st;
+    std::string relative;
+    std::string destination;
+    for (const auto& entry : current.entries) {
+        if (entry.isDirectory)
+            continue;
+
+        relative.assign(current.relativePath(entry));
+        const auto it = previous.find(relative);
+        if (it != previous.end()) {
+            destination.assign(destinationDirectory).append(relative);
+            const bool unchanged = it->second.size == static_cast<u64>(entry.size) && it->second.mtime == entry.mtime &&
+                                   stat(destination.c_str(), &st) == 0 && it->second.destinationMatches(st);
+            previous.erase(it);
+            if (unchanged)
+                continue;
+        }
+        changed.add(entry.root, relative, false, entry.size, entry.mtime);
+    }
+
+    // Whatever is left was mirrored last time but is gone from the source; with -delete_removed
+    // its copy is removed while it is still the file mirror_copy put there
+    for (const auto& [removed, file] : previous) {
+        if (!deleteRemoved)
+            break;
+        if (abortFileOp.load(std::memory_order_acquire))
+            return;
+        destination.assign(destinationDirectory).append(removed);
+        if (stat(destination.c_str(), &st) == 0 && !S_ISDIR(st.st_mode) && file.destinationMatches(st)) {
+            deleteFileOrDirectory(destination);
+        }
+        #if USING_LOGGING_DIRECTIVE
+        else if (!disableLogging) {
+            logMessage("Mirror: not removing " + destination + ", no longer the mirrored copy");
+        }
+        #endif
+    }
+
+    #if USING_LOGGING_DIRECTIVE
+    if (!disableLogging)
+        logMessage("Mirror " + sourceDirectory + ": " + ult::to_string(changed.entries.size()) + " changed, " +
+                   ult::to_string(previous.size()) + " removed");
+    #endif
+
+    // A partial run keeps the old record, so the next run compares against it again
+    if (copyFromManifest(changed))
+        writeMirrorManifest(manifestPath, current, destinationDirectory);
+}
+
 void handleMirrorCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
     // Early validation
     if (cmd.size() < 2) {
@@ -3884,9 +7361,9 @@ void handleMirrorCommand(const std::vector<std::string>& cmd, const std::string&
     std::string sourcePath = cmd[1];
     preprocessPath(sourcePath, packagePath);
     
-    // Extract destination path or use default
+    // Extract destination path or use default (-delete_removed is a flag, not a destination)
     std::string destinationPath;
-    if (cmd.size() >= 3) {
+    if (cmd.size() >= 3 && cmd[2] != "-delete_removed") {
         destinationPath = cmd[2];
         preprocessPath(destinationPath, packagePath);
     } else {
@@ -3896,20 +7373,21 @@ void handleMirrorCommand(const std::vector<std::string>& cmd, const std::string&
     // Determine operation type using string_view to avoid string creation
     const std::string_view commandName = cmd[0];
     const std::string operation = (commandName == "mirror_copy" || commandName == "mirror_cp") ? "copy" : "delete";
+    const bool deleteRemoved = hasCommandFlag(cmd, "-delete_removed");
     
     if (sourcePath.find('*') == std::string::npos) {
         // Single directory mirror
-        mirrorFiles(sourcePath, destinationPath, operation);
+        mirrorFilesIncremental(sourcePath, destinationPath, operation, deleteRemoved);
     } else {
         // Wildcard mirror - get file list and process with immediate cleanup
-        auto fileList = getFilesListByWildcards(sourcePath);
+        auto fileList = getCachedFilesListByWildcards(sourcePath);
         
         // Process files one by one, freeing memory as we go
         for (size_t i = 0; i < fileList.size(); ++i) {
             // Move the string to avoid copy
             const auto sourceDirectory = std::move(fileList[i]);
             fileList[i].shrink_to_fit();     // Free the capacity
-            mirrorFiles(sourceDirectory, destinationPath, operation);
+            mirrorFilesIncremental(sourceDirectory, destinationPath, operation, deleteRemoved);
         }
     }
 }
@@ -3931,13 +7409,7 @@ void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& p
             filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath, packagePath));
         }
 
-        // Stream process both files line by line
-        FILE* sourceFile = fopen(sourceListPath.c_str(), "r");
-        FILE* destFile = fopen(destinationListPath.c_str(), "r");
-        
-        if (!sourceFile || !destFile) {
-            if (sourceFile) fclose(sourceFile);
-            if (destFile) fclose(destFile);
+        if (!isFileOrDirectory(sourceListPath) || !isFileOrDirectory(destinationListPath)) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
                 logMessage("Failed to open source or destination list files");
@@ -3945,42 +7417,17 @@ void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& p
             return;
         }
         
-        // Set larger buffers for better I/O performance
-        static constexpr size_t FILE_BUFFER_SIZE = 8192;
-        setvbuf(sourceFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
-        setvbuf(destFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
-        
-        static constexpr size_t BUFFER_SIZE = 8192;
-        char sourceBuffer[BUFFER_SIZE];
-        char destBuffer[BUFFER_SIZE];
-        
         // Static string for repeated log messages to reduce allocations
         #if USING_LOGGING_DIRECTIVE
         static const std::string skipDirMsg = "Skipping non-empty directory: ";
         #endif
         
-        // Process files line by line simultaneously
-        while (fgets(sourceBuffer, BUFFER_SIZE, sourceFile) && 
-               fgets(destBuffer, BUFFER_SIZE, destFile)) {
-            
-            // Optimized newline removal - scan once instead of using strlen
-            char* srcEnd = sourceBuffer;
-            while (*srcEnd && *srcEnd != '\n') ++srcEnd;
-            const size_t sourceLen = srcEnd - sourceBuffer;
-            *srcEnd = '\0';
-            
-            char* destEnd = destBuffer;
-            while (*destEnd && *destEnd != '\n') ++destEnd;
-            const size_t destLen = destEnd - destBuffer;
-            *destEnd = '\0';
-            
-            // Clear and append to reuse existing string capacity
-            sourcePath.clear();
-            sourcePath.append(sourceBuffer, sourceLen);
-            
-            destinationPath.clear();
-            destinationPath.append(destBuffer, destLen);
-            
+        size_t totalPairs = 0;
+        size_t processedPairs = 0;
+        
+        const auto processPair = [&](const std::string& source, const std::string& destination) {
+            sourcePath = source;
+            destinationPath = destination;
             preprocessPath(sourcePath, packagePath);
             preprocessPath(destinationPath, packagePath);
             
@@ -3988,17 +7435,14 @@ void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& p
             const bool shouldProcess = !filterSet || filterSet->find(sourcePath) == filterSet->end();
             
             if (shouldProcess) {
-                // Check if it's a directory using the buffer directly (avoid string access)
-                const bool isDirectory = sourceLen > 0 && sourcePath[sourceLen - 1] == '/';
+                const bool isDirectory = !sourcePath.empty() && sourcePath.back() == '/';
                 
                 if (!isDirectory) {
                     // Check copy filter once and cache result
                     const bool shouldCopy = copyFilterSet && copyFilterSet->find(sourcePath) != copyFilterSet->end();
                     
                     if (shouldCopy) {
-                        const long long totalSize = getTotalSize(sourcePath);
-                        long long totalBytesCopied = 0;
-                        copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+                        copyFileOrDirectoryBuffered(sourcePath, destinationPath);
                     } else {
                         moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
                     }
@@ -4013,10 +7457,60 @@ void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& p
                     #endif
                 }
             }
-        }
+            
+            // Moves are mostly renames, so progress is reported over the whole list by entry
+            ++processedPairs;
+            copyPercentage.store(static_cast<int>(processedPairs * 100 / totalPairs), std::memory_order_release);
+            return !abortFileOp.load(std::memory_order_acquire);
+        };
         
-        fclose(sourceFile);
-        fclose(destFile);
+        // Stream both lists line by line, counting the entries first for the progress total
+        totalPairs = forEachListFilePair(sourceListPath, destinationListPath, [](const std::string&, const std::string&) { return true; });
+        
+        if (hasCommandFlag(cmd, "-sort")) {
+            // Group the moves by destination directory so its FAT entry updates stay together. Only
+            // a bounded run of pairs is sorted at a time, and a run ends before any pair that touches
+            // a path an earlier pair of the run moves from or to, so dependent moves keep their order.
+            static constexpr size_t MOVE_SORT_RUN = 256;
+            std::vector<std::pair<std::string, std::string>> run;
+            run.reserve(MOVE_SORT_RUN);
+            PlannedPathSet runPaths;
+            std::string from, to;
+            bool keepGoing = true;
+            
+            const auto moveRun = [&]() {
+                std::stable_sort(run.begin(), run.end(), [](const auto& a, const auto& b) {
+                    return getEntryDirectory(a.second) < getEntryDirectory(b.second);
+                });
+                for (const auto& [source, destination] : run) {
+                    if (!processPair(source, destination)) {
+                        keepGoing = false;
+                        break;
+                    }
+                }
+                run.clear();
+                runPaths.clear();
+                return keepGoing;
+            };
+            
+            forEachListFilePair(sourceListPath, destinationListPath, [&](const std::string& source, const std::string& destination) {
+                from = source;
+                preprocessPath(from, packagePath);
+                to = destination;
+                preprocessPath(to, packagePath);
+                
+                if ((run.size() >= MOVE_SORT_RUN || runPaths.overlaps(from) || runPaths.overlaps(to)) && !moveRun())
+                    return false;
+                run.emplace_back(source, destination);
+                runPaths.insert(from);
+                runPaths.insert(to);
+                return true;
+            });
+            if (keepGoing)
+                moveRun();
+        } else {
+            forEachListFilePair(sourceListPath, destinationListPath, processPair);
+        }
         
     } else {
         // Single file/directory moving - early returns for error conditions
@@ -4062,7 +7556,7 @@ void handleIniCommands(const std::vector<std::string>& cmd, const std::string& p
     preprocessPath(sourcePath, packagePath);
     std::string desiredSection = cmd[2];
     removeQuotes(desiredSection);
-    
+
     if (command == "add-ini-section") {
         addIniSection(sourcePath, desiredSection);
         
@@ -4123,6 +7617,13 @@ void handleIniCommands(const std::vector<std::string>& cmd, const std::string& p
         // desiredSection here is the pattern key
         removeKeyFromMatchingSections(sourcePath, desiredSection, desiredKey);
     }
+    
+    // After the write, so a reader in between cannot cache the old contents again.
+    // The *-matching-key commands take a key pattern instead of a section and may touch [memory]
+    const bool matchingKey = command.size() > 13 && command.compare(command.size() - 13, 13, "-matching-key") == 0;
+    if (sourcePath == ULTRAHAND_CONFIG_INI_PATH && (desiredSection == MEMORY_STR || matchingKey))
+        invalidateMemoryConfig();
+    invalidateIniIndex(sourcePath);
 }
 
 void handleJsonCommands(const std::vector<std::string>& cmd, const std::string& packagePath) {
@@ -4151,6 +7652,9 @@ void handleJsonCommands(const std::vector<std::string>& cmd, const std::string&
     } else if (command == "set-json-val" || command == "set-json-value") {
         ult::setJsonValue(sourcePath, key, value, true);
     }
+    
+    // After the write, so a reader in between cannot cache the old document again
+    invalidateCachedJsonDocument(sourcePath);
 }
 
 void handleHexEdit(const std::string& sourcePath, const std::string& secondArg, const std::string& thirdArg, const std::string& fourthArg, const std::string& fifthArg, const std::string& commandName, const std::vector<std::string>& cmd) {
@@ -4303,25 +7807,37 @@ void executeIniCommands(const std::string &iniPath, const std::string &section,
 }
 
 // Main processCommand function
-void processCommand(const std::vector<std::string>& cmd, const std::string& packagePath = "", const std::string& selectedCommand = "") {
+void processCommand(CommandOpcode opcode, const std::vector<std::string>& cmd, const std::string& packagePath, const std::string& selectedCommand) {
     const std::string& commandName = cmd[0];
     const size_t cmdSize = cmd.size();
-    
-    // Fast path dispatch by first character
-    switch (commandName[0]) {
-        case 'a':
-            if (commandName == "add-ini-section") {
-                handleIniCommands(cmd, packagePath);
-                return;
+
+    // Listings and parsed files read before or during a command that changes the file tree are
+    // stale afterwards
+    struct FileMutationGuard {
+        const bool active;
+        ~FileMutationGuard() {
+            if (active) {
+                invalidateFileCaches();
             }
-            break;
+        }
+    } mutationGuard{changesFileTree(opcode)};
+    
+    // Dispatch on the opcode resolved at compile time
+    switch (opcode) {
+        case CommandOpcode::IniCommand:
+            handleIniCommands(cmd, packagePath);
+            return;
             
-        case 'b':
-            if (commandName == "back") {
-                goBackAfter.store(true, std::memory_order_release);
-                return;
-            }
-            if (cmdSize >= 2 && commandName == "backlight") {
+        case CommandOpcode::JsonCommand:
+            handleJsonCommands(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Back:
+            goBackAfter.store(true, std::memory_order_release);
+            return;
+            
+        case CommandOpcode::Backlight:
+            if (cmdSize >= 2) {
                 std::string togglePattern = getUnquoted(cmd, 1);
                 lblInitialize();
                 if (togglePattern == "auto") {
@@ -4340,31 +7856,31 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                     lblSetCurrentBrightnessSetting(ult::stof(togglePattern) / 100.0f);
                 }
                 lblExit();
-                return;
+                invalidateGeneralPlaceholders("{backlight}");
             }
-            break;
+            return;
             
-        case 'c':
-            if (commandName == "cp" || commandName == "copy") {
-                handleCopyCommand(cmd, packagePath);
-                return;
-            }
-            if (commandName == "compare") {
-                if (cmdSize >= 4) {
-                    std::string path1 = cmd[1];
-                    preprocessPath(path1, packagePath);
-                    std::string path2 = cmd[2];
-                    preprocessPath(path2, packagePath);
-                    std::string outputPath = cmd[3];
-                    preprocessPath(outputPath, packagePath);
-                    if (path1.find('*') != std::string::npos)
-                        compareWildcardFilesLists(path1, path2, outputPath);
-                    else
-                        compareFilesLists(path1, path2, outputPath);
-                }
-                return;
+        case CommandOpcode::Copy:
+            handleCopyCommand(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Compare:
+            if (cmdSize >= 4) {
+                std::string path1 = cmd[1];
+                preprocessPath(path1, packagePath);
+                std::string path2 = cmd[2];
+                preprocessPath(path2, packagePath);
+                std::string outputPath = cmd[3];
+                preprocessPath(outputPath, packagePath);
+                if (path1.find('*') != std::string::npos)
+                    compareWildcardFilesLists(path1, path2, outputPath);
+                else
+                    compareFilesLists(path1, path2, outputPath);
             }
-            if (cmdSize >= 2 && commandName == "clear") {
+            return;
+            
+        case CommandOpcode::Clear:
+            if (cmdSize >= 2) {
                 const std::string clearOption = getUnquoted(cmd, 1);
                 if (clearOption == "log") {
                     #if USING_LOGGING_DIRECTIVE
@@ -4372,57 +7888,59 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                     #endif
                 } else if (clearOption == "hex_sum_cache") {
                     hexSumCache.clear();
+                    clearHexFileImageCache();
+                } else if (clearOption == "profile") {
+                    clearCommandProfile();
                 }
-                return;
             }
-            break;
+            return;
             
-        case 'd':
-            if (commandName == "del" || commandName == "delete") {
-                handleDeleteCommand(cmd, packagePath);
-                return;
-            }
-            if (commandName == "download" || commandName == "download-no-retry") {
-                if (cmdSize >= 3) {
-                    std::string fileUrl = cmd[1];
-                    preprocessUrl(fileUrl);
-                    std::string destinationPath = cmd[2];
-                    preprocessPath(destinationPath, packagePath);
-                    bool downloadSuccess = false;
-                    
-                    const bool shouldRetry = (commandName == "download");
-                    const size_t maxAttempts = shouldRetry ? 3 : 1;
-                    
-                    for (size_t i = 0; i < maxAttempts; ++i) {
-                        downloadSuccess = downloadFile(fileUrl, destinationPath);
-                        if (abortDownload.load(std::memory_order_acquire)) {
-                            downloadSuccess = false;
-                            break;
-                        }
-                        if (downloadSuccess) break;
-                        
-                        if (shouldRetry && i < maxAttempts - 1) {
-                            svcSleepThread(200'000'000);
-                        }
+        case CommandOpcode::Delete:
+            handleDeleteCommand(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Download:
+        case CommandOpcode::DownloadNoRetry:
+            if (cmdSize >= 3) {
+                std::string fileUrl = cmd[1];
+                preprocessUrl(fileUrl);
+                std::string destinationPath = cmd[2];
+                preprocessPath(destinationPath, packagePath);
+                bool downloadSuccess = false;
+                
+                const bool shouldRetry = (opcode == CommandOpcode::Download);
+                const size_t maxAttempts = shouldRetry ? 3 : 1;
+                
+                for (size_t i = 0; i < maxAttempts; ++i) {
+                    downloadSuccess = downloadFile(fileUrl, destinationPath);
+                    if (abortDownload.load(std::memory_order_acquire)) {
+                        downloadSuccess = false;
+                        break;
                     }
+                    if (downloadSuccess) break;
                     
-                    commandSuccess.store(
-                        downloadSuccess && commandSuccess.load(std::memory_order_acquire),
-                        std::memory_order_release
-                    );
+                    if (shouldRetry && i < maxAttempts - 1) {
+                        svcSleepThread(200'000'000);
+                    }
                 }
-                return;
+                
+                commandSuccess.store(
+                    downloadSuccess && commandSuccess.load(std::memory_order_acquire),
+                    std::memory_order_release
+                );
             }
-            if (cmdSize >= 2 && commandName == "dot-clean") {
+            return;
+            
+        case CommandOpcode::DotClean:
+            if (cmdSize >= 2) {
                 std::string path = cmd[1];
                 preprocessPath(path, packagePath);
                 dotCleanDirectory(path);
-                return;
             }
-            break;
+            return;
             
-        case 'e':
-            if (cmdSize >= 2 && commandName == "exec") {
+        case CommandOpcode::Exec:
+            if (cmdSize >= 2) {
                 const std::string sectionName = getUnquoted(cmd, 1);
                 
                 if (cmdSize >= 3) {
@@ -4453,251 +7971,225 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                     if (resetCommandSuccess)
                         setCommandFailed();
                 }
-                return;
-            }
-            if (commandName == "exit") {
-                if (cmdSize >= 2) {
-                    const std::string selection = getUnquoted(cmd, 1);
-                    if (selection == "overlays") {
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
-                    } else if (selection == "packages") {
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "to_packages", TRUE_STR);
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
-                    }
-                }
-                exitingUltrahand.store(true, std::memory_order_release);
-                ult::launchingOverlay.store(true, std::memory_order_release);
-                tsl::setNextOverlay(OVERLAY_PATH+"ovlmenu.ovl");
-                tsl::Overlay::get()->close(true);
-                return;
-            }
-
-            break;
-            
-        case 'f':
-            if (commandName == "flag") {
-                if (cmdSize >= 3) {
-                    std::string wildcardPattern = cmd[1];
-                    preprocessPath(wildcardPattern, packagePath);
-                    std::string outputDir = cmd[2];
-                    preprocessPath(outputDir, packagePath);
-                    createFlagFiles(wildcardPattern, outputDir);
-                } else {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Usage: flag <wildcardPattern> <outputDir>");
-                    #endif
-                }
-                return;
             }
-            break;
+            return;
             
-        case 'h':
-            if (commandName.compare(0, 7, "hex-by-") == 0) {
-                if (cmdSize >= 4) {
-                    std::string sourcePath = cmd[1];
-                    preprocessPath(sourcePath, packagePath);
-                    
-                    const std::string secondArg = getUnquoted(cmd, 2);
-                    const std::string thirdArg = getUnquoted(cmd, 3);
-                    
-                    std::string fourthArg;
-                    if (cmdSize >= 5)
-                        fourthArg = getUnquoted(cmd, 4);
-                    
-                    std::string fifthArg;
-                    if (cmdSize >= 6)
-                        fifthArg = getUnquoted(cmd, 5);
-                    
-                    if (commandName == "hex-by-custom-offset" || 
-                        commandName == "hex-by-custom-decimal-offset" || 
-                        commandName == "hex-by-custom-rdecimal-offset") {
-                        if (cmdSize >= 5) {
-                            const std::string customPattern = getUnquoted(cmd, 2);
-                            const std::string offset = getUnquoted(cmd, 3);
-                            const std::string hexDataReplacement = getUnquoted(cmd, 4);
-                            
-                            std::string byteGroupSize;
-                            if (cmdSize >= 6)
-                                byteGroupSize = getUnquoted(cmd, 5);
-                            
-                            handleHexByCustom(sourcePath, customPattern, offset, hexDataReplacement, commandName, byteGroupSize);
-                        }
-                    } else {
-                        handleHexEdit(sourcePath, secondArg, thirdArg, fourthArg, fifthArg, commandName, cmd);
-                    }
+        case CommandOpcode::Exit:
+            if (cmdSize >= 2) {
+                const std::string selection = getUnquoted(cmd, 1);
+                if (selection == "overlays") {
+                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
+                } else if (selection == "packages") {
+                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "to_packages", TRUE_STR);
+                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
                 }
-                return;
-            }
-            break;
-            
-        case 'l':
-            if (commandName == "logging") {
-                interpreterLogging.store(true, std::memory_order_release);
-                return;
             }
-            break;
+            exitingUltrahand.store(true, std::memory_order_release);
+            ult::launchingOverlay.store(true, std::memory_order_release);
+            tsl::setNextOverlay(OVERLAY_PATH+"ovlmenu.ovl");
+            tsl::Overlay::get()->close(true);
+            return;
             
-        case 'm':
-            if (commandName == "mkdir" || commandName == "make") {
-                handleMakeDirCommand(cmd, packagePath);
-                return;
-            }
-            if (commandName == "mv" || commandName == "move") {
-                handleMoveCommand(cmd, packagePath);
-                return;
-            }
-            if (commandName.compare(0, 7, "mirror_") == 0) {
-                handleMirrorCommand(cmd, packagePath);
-                return;
+        case CommandOpcode::Flag:
+            if (cmdSize >= 3) {
+                std::string wildcardPattern = cmd[1];
+                preprocessPath(wildcardPattern, packagePath);
+                std::string outputDir = cmd[2];
+                preprocessPath(outputDir, packagePath);
+                createFlagFiles(wildcardPattern, outputDir);
+            } else {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Usage: flag <wildcardPattern> <outputDir>");
+                #endif
             }
-            break;
+            return;
             
-        case 'n':
-            if ((commandName == "notify" || commandName == "notification" || 
-                 commandName == "notify-now" || commandName == "notification-now")) {
-                if (cmdSize > 1) {
-                    const std::string text = getUnquoted(cmd, 1);
-                    
-                    int fontSize = 28;
-                    if (cmdSize > 2) {
-                        const std::string fontStr = getUnquoted(cmd, 2);
-                        if (isValidNumber(fontStr)) {
-                            fontSize = std::clamp(std::stoi(fontStr), 1, 34);
-                        }
-                    }
-                    
-                    if (tsl::notification) {
-                        const bool now = (commandName.find("-now") != std::string::npos);
+        case CommandOpcode::HexEdit:
+            if (cmdSize >= 4) {
+                std::string sourcePath = cmd[1];
+                preprocessPath(sourcePath, packagePath);
+                invalidateHexFileImage(sourcePath);
+                
+                const std::string secondArg = getUnquoted(cmd, 2);
+                const std::string thirdArg = getUnquoted(cmd, 3);
+                
+                std::string fourthArg;
+                if (cmdSize >= 5)
+                    fourthArg = getUnquoted(cmd, 4);
+                
+                std::string fifthArg;
+                if (cmdSize >= 6)
+                    fifthArg = getUnquoted(cmd, 5);
+                
+                if (commandName == "hex-by-custom-offset" || 
+                    commandName == "hex-by-custom-decimal-offset" || 
+                    commandName == "hex-by-custom-rdecimal-offset") {
+                    if (cmdSize >= 5) {
+                        const std::string customPattern = getUnquoted(cmd, 2);
+                        const std::string offset = getUnquoted(cmd, 3);
+                        const std::string hexDataReplacement = getUnquoted(cmd, 4);
+                        
+                        std::string byteGroupSize;
+                        if (cmdSize >= 6)
+                            byteGroupSize = getUnquoted(cmd, 5);
                         
-                        if (now)
-                            tsl::notification->showNow(text, fontSize);
-                        else
-                            tsl::notification->show(text, fontSize);
+                        handleHexByCustom(sourcePath, customPattern, offset, hexDataReplacement, commandName, byteGroupSize);
                     }
+                } else {
+                    handleHexEdit(sourcePath, secondArg, thirdArg, fourthArg, fifthArg, commandName, cmd);
                 }
-                return;
             }
-            break;
+            return;
             
-        case 'o':
-            if (commandName == "open") {
-                if (cmdSize >= 2) {
-                    std::string overlayPath = getUnquoted(cmd, 1);
-                    preprocessPath(overlayPath, packagePath);
-                    
-                    if (!isFile(overlayPath)) {
-                        #if USING_LOGGING_DIRECTIVE
-                        if (!disableLogging)
-                            logMessage("Overlay file not found: " + overlayPath);
-                        #endif
-                        setCommandFailed();
-                        return;
-                    }
-                    
-                    std::string launchArgs;
-                    if (cmdSize > 2) {
-                        for (size_t i = 2; i < cmdSize; ++i) {
-                            if (i > 2) launchArgs += " ";
-                            launchArgs += getUnquoted(cmd, i);
-                        }
-                    }
-                    
-                    {
-                        std::lock_guard<std::mutex> lock(ult::overlayLaunchMutex);
-                        ult::requestedOverlayPath = overlayPath;
-                        ult::requestedOverlayArgs = launchArgs;
-                        ult::overlayLaunchRequested.store(true, std::memory_order_release);
+        case CommandOpcode::Logging:
+            interpreterLogging.store(true, std::memory_order_release);
+            return;
+            
+        case CommandOpcode::MakeDir:
+            handleMakeDirCommand(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Move:
+            handleMoveCommand(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Mirror:
+            handleMirrorCommand(cmd, packagePath);
+            return;
+            
+        case CommandOpcode::Notify:
+            if (cmdSize > 1) {
+                const std::string text = getUnquoted(cmd, 1);
+                
+                int fontSize = 28;
+                if (cmdSize > 2) {
+                    const std::string fontStr = getUnquoted(cmd, 2);
+                    if (isValidNumber(fontStr)) {
+                        fontSize = std::clamp(std::stoi(fontStr), 1, 34);
                     }
+                }
+                
+                if (tsl::notification) {
+                    const bool now = (commandName.find("-now") != std::string::npos);
                     
+                    if (now)
+                        tsl::notification->showNow(text, fontSize);
+                    else
+                        tsl::notification->show(text, fontSize);
+                }
+            }
+            return;
+            
+        case CommandOpcode::Open:
+            if (cmdSize >= 2) {
+                std::string overlayPath = getUnquoted(cmd, 1);
+                preprocessPath(overlayPath, packagePath);
+                
+                if (!isFile(overlayPath)) {
                     #if USING_LOGGING_DIRECTIVE
                     if (!disableLogging)
-                        logMessage("Requesting overlay launch: " + overlayPath + " with args: " + launchArgs);
-                    #endif
-                    
-                    return;
-                } else {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Usage: open <overlay_path> [launch_arguments...]");
+                        logMessage("Overlay file not found: " + overlayPath);
                     #endif
                     setCommandFailed();
                     return;
                 }
-            }
-            break;
-            
-        case 'p':
-            if (commandName == "path_exists") {
-                if (cmdSize >= 2) {
-                    std::string sourcePath = cmd[1];
-                    preprocessPath(sourcePath, packagePath);
-                    if (ult::isFileOrDirectory(sourcePath)) {
-                        commandSuccess.store(true, std::memory_order_release);
-                    } else {
-                        commandSuccess.store(false, std::memory_order_release);
+                
+                std::string launchArgs;
+                if (cmdSize > 2) {
+                    for (size_t i = 2; i < cmdSize; ++i) {
+                        if (i > 2) launchArgs += " ";
+                        launchArgs += getUnquoted(cmd, i);
                     }
                 }
-            }
-            if (commandName == "pchtxt2ips") {
-                if (cmdSize >= 3) {
-                    std::string sourcePath = cmd[1];
-                    preprocessPath(sourcePath, packagePath);
-                    std::string destinationPath = cmd[2];
-                    preprocessPath(destinationPath, packagePath);
-                    commandSuccess.store(
-                        pchtxt2ips(sourcePath, destinationPath) && commandSuccess.load(std::memory_order_acquire),
-                        std::memory_order_release
-                    );
+                
+                {
+                    std::lock_guard<std::mutex> lock(ult::overlayLaunchMutex);
+                    ult::requestedOverlayPath = overlayPath;
+                    ult::requestedOverlayArgs = launchArgs;
+                    ult::overlayLaunchRequested.store(true, std::memory_order_release);
                 }
+                
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Requesting overlay launch: " + overlayPath + " with args: " + launchArgs);
+                #endif
+                
                 return;
-            }
-            if (commandName == "pchtxt2cheat") {
-                if (cmdSize >= 2) {
-                    std::string sourcePath = cmd[1];
-                    preprocessPath(sourcePath, packagePath);
-                    if (cmdSize >= 3) {
-                        const std::string cheatName = cmd[2];
-                        commandSuccess.store(
-                            pchtxt2cheat(sourcePath, cheatName) && commandSuccess.load(std::memory_order_acquire),
-                            std::memory_order_release
-                        );
-                    } else {
-                        commandSuccess.store(
-                            pchtxt2cheat(sourcePath) && commandSuccess.load(std::memory_order_acquire),
-                            std::memory_order_release
-                        );
-                    }
-                }
+            } else {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Usage: open <overlay_path> [launch_arguments...]");
+                #endif
+                setCommandFailed();
                 return;
             }
-            break;
             
-        case 'r':
-            if (commandName == "rename") {
-                handleMoveCommand(cmd, packagePath);
-                return;
+        case CommandOpcode::PathExists:
+            if (cmdSize >= 2) {
+                std::string sourcePath = cmd[1];
+                preprocessPath(sourcePath, packagePath);
+                if (ult::isFileOrDirectory(sourcePath)) {
+                    commandSuccess.store(true, std::memory_order_release);
+                } else {
+                    commandSuccess.store(false, std::memory_order_release);
+                }
             }
-            if (commandName == "rename-ini-section" || commandName == "remove-ini-section" || 
-                commandName == "remove-ini-key" || commandName == "remove-ini-key-matching-key") {
-                handleIniCommands(cmd, packagePath);
-                return;
+            return;
+            
+        case CommandOpcode::Pchtxt2Ips:
+            if (cmdSize >= 3) {
+                std::string sourcePath = cmd[1];
+                preprocessPath(sourcePath, packagePath);
+                std::string destinationPath = cmd[2];
+                preprocessPath(destinationPath, packagePath);
+                commandSuccess.store(
+                    pchtxt2ips(sourcePath, destinationPath) && commandSuccess.load(std::memory_order_acquire),
+                    std::memory_order_release
+                );
             }
-            if (commandName == "refresh") {
-                if (cmdSize == 1) {
-                    refreshPage.store(true, std::memory_order_release);
+            return;
+            
+        case CommandOpcode::Pchtxt2Cheat:
+            if (cmdSize >= 2) {
+                std::string sourcePath = cmd[1];
+                preprocessPath(sourcePath, packagePath);
+                if (cmdSize >= 3) {
+                    const std::string cheatName = cmd[2];
+                    commandSuccess.store(
+                        pchtxt2cheat(sourcePath, cheatName) && commandSuccess.load(std::memory_order_acquire),
+                        std::memory_order_release
+                    );
                 } else {
-                    const std::string refreshPattern = getUnquoted(cmd, 1);
-                    if (refreshPattern == "theme")
-                        tsl::initializeThemeVars();
-                    else if (refreshPattern == "package")
-                        refreshPackage.store(true, std::memory_order_release);
-                    else if (refreshPattern == "wallpaper")
-                        refreshWallpaperNow.store(true, std::memory_order_release);
+                    commandSuccess.store(
+                        pchtxt2cheat(sourcePath) && commandSuccess.load(std::memory_order_acquire),
+                        std::memory_order_release
+                    );
                 }
-                return;
             }
-            if (cmdSize > 1 && commandName == "refresh-to") {
+            return;
+            
+        case CommandOpcode::Profile:
+            clearCommandProfile(packagePath);
+            interpreterProfiling.store(true, std::memory_order_release);
+            return;
+            
+        case CommandOpcode::Refresh:
+            if (cmdSize == 1) {
+                refreshPage.store(true, std::memory_order_release);
+            } else {
+                const std::string refreshPattern = getUnquoted(cmd, 1);
+                if (refreshPattern == "theme")
+                    tsl::initializeThemeVars();
+                else if (refreshPattern == "package")
+                    refreshPackage.store(true, std::memory_order_release);
+                else if (refreshPattern == "wallpaper")
+                    refreshWallpaperNow.store(true, std::memory_order_release);
+            }
+            return;
+            
+        case CommandOpcode::RefreshTo:
+            if (cmdSize > 1) {
                 const std::string refreshPattern = getUnquoted(cmd, 1);
                 std::string refreshPattern2 = "";
                 std::string refreshPattern3 = "";
@@ -4713,9 +8205,10 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                 jumpItemExactMatch = !(refreshPattern3 == FALSE_STR);
                 skipJumpReset.store(true, std::memory_order_release);
                 refreshPage.store(true, std::memory_order_release);
-                return;
             }
-            if (commandName == "reboot") {
+            return;
+            
+        case CommandOpcode::Reboot: {
                 bool launchUpdaterPayload = false;
                 for (const std::string& file : PROTECTED_FILES) {
                     if (isFile(file + ".ultra")) {
@@ -4800,29 +8293,20 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                     spsmExit();
                 }
                 return;
-            }
-            break;
+        }
             
-        case 's':
-            if (commandName == "set-ini-val" || commandName == "set-ini-value" || 
-                commandName == "set-ini-key" || commandName == "set-ini-val-matching-key") {
-                handleIniCommands(cmd, packagePath);
-                return;
-            }
-            if (commandName == "set-json-val" || commandName == "set-json-value" || 
-                commandName == "set-json-key") {
-                handleJsonCommands(cmd, packagePath);
-                return;
-            }
-            if (cmdSize >= 2 && commandName == "set-footer") {
+        case CommandOpcode::SetFooter:
+            if (cmdSize >= 2) {
                 const std::string desiredValue = getUnquoted(cmd, 1);
                 if (desiredValue.find(NULL_STR) != std::string::npos)
                     setCommandFailed();
                 else
                     setIniFileValue((packagePath + CONFIG_FILENAME), selectedCommand, FOOTER_STR, desiredValue);
-                return;
             }
-            if (cmdSize > 1 && commandName == "set-region") {
+            return;
+            
+        case CommandOpcode::SetRegion:
+            if (cmdSize > 1) {
                 const std::string regionStr = stringToUppercase(getUnquoted(cmd, 1));
                 
                 SetRegion region;
@@ -4850,27 +8334,26 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                 } else {
                     setCommandFailed();
                 }
-                return;
             }
-            if (commandName == "shutdown") {
-                if (cmdSize >= 2) {
-                    const std::string selection = getUnquoted(cmd, 1);
-                    if (selection == "controllers") {
-                        powerOffAllControllers();
-                    }
-                } else {
-                    fsdevUnmountAll();
-                    if (R_SUCCEEDED(spsmInitialize())) {
-                        spsmShutdown(SpsmShutdownMode_Normal);
-                        spsmExit();
-                    }
+            return;
+            
+        case CommandOpcode::Shutdown:
+            if (cmdSize >= 2) {
+                const std::string selection = getUnquoted(cmd, 1);
+                if (selection == "controllers") {
+                    powerOffAllControllers();
+                }
+            } else {
+                fsdevUnmountAll();
+                if (R_SUCCEEDED(spsmInitialize())) {
+                    spsmShutdown(SpsmShutdownMode_Normal);
+                    spsmExit();
                 }
-                return;
             }
-            break;
+            return;
             
-        case 'u':
-            if (cmdSize >= 3 && commandName == "unzip") {
+        case CommandOpcode::Unzip:
+            if (cmdSize >= 3) {
                 std::string sourcePath = cmd[1];
                 preprocessPath(sourcePath, packagePath);
                 std::string destinationPath = cmd[2];
@@ -4879,74 +8362,142 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                     unzipFile(sourcePath, destinationPath) && commandSuccess.load(std::memory_order_acquire),
                     std::memory_order_release
                 );
-                return;
             }
-            break;
+            return;
             
-        case 'v':
-            if (commandName == "volume") {
-                if (cmdSize >= 2) {
-                    const std::string volumeInput = getUnquoted(cmd, 1);
+        case CommandOpcode::Volume:
+            if (cmdSize >= 2) {
+                const std::string volumeInput = getUnquoted(cmd, 1);
+                
+                if (isValidNumber(volumeInput)) {
+                    const float volumePercentage = ult::stof(volumeInput);
                     
-                    if (isValidNumber(volumeInput)) {
-                        const float volumePercentage = ult::stof(volumeInput);
-                        
-                        if (volumePercentage < 0.0f || volumePercentage > 150.0f) {
-                            return;
-                        }
-                        
-                        const float masterVolume = volumePercentage / 100.0f;
-                        
-                        audctlInitialize();
-                        audctlSetSystemOutputMasterVolume(masterVolume);
-                        audctlExit();
+                    if (volumePercentage < 0.0f || volumePercentage > 150.0f) {
+                        return;
                     }
-                } else {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Volume command missing required argument.");
-                    #endif
+                    
+                    const float masterVolume = volumePercentage / 100.0f;
+                    
+                    audctlInitialize();
+                    audctlSetSystemOutputMasterVolume(masterVolume);
+                    audctlExit();
+                    invalidateGeneralPlaceholders("{volume}");
                 }
-                return;
+            } else {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Volume command missing required argument.");
+                #endif
             }
-            break;
-
-        case '!':
-            if (commandName == "!path_exists") {
-                if (cmdSize >= 2) {
-                    std::string sourcePath = cmd[1];
-                    preprocessPath(sourcePath, packagePath);
-                    if (ult::isFileOrDirectory(sourcePath)) {
-                        commandSuccess.store(false, std::memory_order_release);
-                    } else {
-                        commandSuccess.store(true, std::memory_order_release);
-                    }
+            return;
+            
+        case CommandOpcode::NotPathExists:
+            if (cmdSize >= 2) {
+                std::string sourcePath = cmd[1];
+                preprocessPath(sourcePath, packagePath);
+                if (ult::isFileOrDirectory(sourcePath)) {
+                    commandSuccess.store(false, std::memory_order_release);
+                } else {
+                    commandSuccess.store(true, std::memory_order_release);
                 }
             }
+            return;
+            
+        default:
+            break;
     }
 }
 
+// Convenience overload that resolves the opcode from the command name
+void processCommand(const std::vector<std::string>& cmd, const std::string& packagePath = "", const std::string& selectedCommand = "") {
+    processCommand(getCommandOpcode(cmd[0]), cmd, packagePath, selectedCommand);
+}
+
 
 
 // Thread information structure
 Thread interpreterThread;
 std::atomic<bool> interpreterThreadExit{false};
+static bool interpreterWorkerStarted = false; // only touched from the UI thread
+static int interpreterWorkerStackSize = 0;     // stack size the worker was created with (UI thread)
 
-// Cache for stack size to avoid repeated INI parsing
-static int cachedStackSize = 0;
+// Called on the interpreter worker once a job has finished (success reflects commandSuccess)
+using InterpreterJobCallback = std::function<void(u32 jobId, bool success)>;
 
-// Work data structure to pass to thread
+// Work data structure passed to the worker through the job queue
 struct InterpreterWorkData {
+    u32 jobId;
     std::vector<std::vector<std::string>> commands;
     std::string packagePath;
     std::string selectedCommand;
+    InterpreterJobCallback onComplete;
+    #if USING_LOGGING_DIRECTIVE
+    // Logging settings of the queuing package, applied by the worker when the job starts
+    bool disableLogging = true;
+    std::string logFilePath;
+    #endif
     
-    InterpreterWorkData(std::vector<std::vector<std::string>>&& cmds, 
+    InterpreterWorkData(u32 id,
+                       std::vector<std::vector<std::string>>&& cmds, 
                        const std::string& path, 
-                       const std::string& selected)
-        : commands(std::move(cmds)), packagePath(path), selectedCommand(selected) {}
+                       const std::string& selected,
+                       InterpreterJobCallback&& callback)
+        : jobId(id), commands(std::move(cmds)), packagePath(path), selectedCommand(selected),
+          onComplete(std::move(callback)) {}
+};
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring of pending interpreter jobs.
+ *
+ * The UI thread is the only producer and the interpreter worker is the only consumer.
+ */
+template <size_t Capacity>
+class InterpreterJobQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(InterpreterWorkData* job) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false; // full
+        }
+        slots_[head & (Capacity - 1)] = job;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    InterpreterWorkData* pop() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr; // empty
+        }
+        InterpreterWorkData* job = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return job;
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    InterpreterWorkData* slots_[Capacity] = {};
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
 };
 
+static InterpreterJobQueue<8> interpreterJobQueue;
+static Semaphore interpreterJobSemaphore;  // one count per queued job (plus one for exit)
+
+// Job bookkeeping
+static std::atomic<u32> nextInterpreterJobId{1};
+static std::atomic<u32> activeInterpreterJobId{0};
+static std::atomic<u32> lastCompletedInterpreterJobId{0};
+static std::atomic<u32> pendingInterpreterJobs{0};       // queued or running
+static std::atomic<u32> cancelInterpreterJobsBefore{0};  // queued jobs with a lower id are skipped
+static std::mutex cancelledInterpreterJobsMutex;
+static std::unordered_set<u32> cancelledInterpreterJobs;
+
 inline void clearInterpreterFlags(bool state = false) {
     // Use relaxed ordering for simple flag clearing - these are just state flags
     // and don't need acquire-release synchronization
@@ -4956,21 +8507,52 @@ inline void clearInterpreterFlags(bool state = false) {
     abortCommand.store(state, std::memory_order_relaxed);
 }
 
-void backgroundInterpreter(void* workPtr) {
-    // Get work data directly - no queue needed
-    auto workData = static_cast<InterpreterWorkData*>(workPtr);
-    
-    // Check for exit signal before starting work
-    if (interpreterThreadExit.load(std::memory_order_acquire)) {
-        delete workData;
+// Returns true (and forgets the request) if the job was cancelled before it could run
+static bool takeInterpreterJobCancellation(u32 jobId) {
+    if (jobId < cancelInterpreterJobsBefore.load(std::memory_order_acquire)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(cancelledInterpreterJobsMutex);
+    return cancelledInterpreterJobs.erase(jobId) > 0;
+}
+
+/**
+ * @brief Cancels a single interpreter job.
+ *
+ * A queued job is skipped when the worker reaches it; a running job is aborted
+ * through the usual abort flags. Finished or unknown ids are ignored.
+ */
+void cancelInterpreterJob(u32 jobId) {
+    if (jobId == 0 || jobId <= lastCompletedInterpreterJobId.load(std::memory_order_acquire)) {
         return;
     }
+    {
+        std::lock_guard<std::mutex> lock(cancelledInterpreterJobsMutex);
+        cancelledInterpreterJobs.insert(jobId);
+    }
+    if (activeInterpreterJobId.load(std::memory_order_acquire) == jobId) {
+        clearInterpreterFlags(true);
+    }
+}
+
+// Skips every job that is still waiting in the queue (the running job is left to the abort flags)
+void cancelQueuedInterpreterJobs() {
+    cancelInterpreterJobsBefore.store(nextInterpreterJobId.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+static void runInterpreterJob(InterpreterWorkData* workData) {
+    const u32 jobId = workData->jobId;
+    bool ran = false;
     
+    // Publish the active id before checking cancellation so a concurrent cancel is never lost
+    activeInterpreterJobId.store(jobId, std::memory_order_release);
+    clearInterpreterFlags();
 
-    // Process the work if we have commands
-    if (!workData->commands.empty()) {
-        // Clear flags and setup for execution
-        clearInterpreterFlags();
+    if (!takeInterpreterJobCancellation(jobId) && !workData->commands.empty()) {
+        #if USING_LOGGING_DIRECTIVE
+        disableLogging = workData->disableLogging;
+        logFilePath = workData->logFilePath;
+        #endif
         resetPercentages();
         threadFailure.store(false, std::memory_order_release);
         
@@ -4980,98 +8562,140 @@ void backgroundInterpreter(void* workPtr) {
         interpretAndExecuteCommands(std::move(workData->commands), 
                                    std::move(workData->packagePath), 
                                    std::move(workData->selectedCommand));
+        ran = true;
 
         // Brief sleep before cleanup
         svcSleepThread(200'000'000);
 
-        // Cleanup
-        runningInterpreter.store(false, std::memory_order_release);
         clearInterpreterFlags();
         resetPercentages();
     }
+
+    activeInterpreterJobId.store(0, std::memory_order_release);
+    lastCompletedInterpreterJobId.store(jobId, std::memory_order_release);
+
+    const bool success = ran && commandSuccess.load(std::memory_order_acquire);
+    if (workData->onComplete) {
+        workData->onComplete(jobId, success);
+    }
     
     // Clean up work data
     delete workData;
+    pendingInterpreterJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+    // Stay "running" while more work is queued so the UI doesn't flicker between jobs
+    if (interpreterJobQueue.empty()) {
+        runningInterpreter.store(false, std::memory_order_release);
+    }
     
-    if (ult::isHidden.load(std::memory_order_acquire)) {
+    if (ran && ult::isHidden.load(std::memory_order_acquire)) {
         if (tsl::notification && ult::useNotifications) {
-            if (commandSuccess.load(std::memory_order_acquire))
+            if (success)
                 tsl::notification->show(NOTIFY_HEADER + TASK_IS_COMPLETE);
             else
                 tsl::notification->show(NOTIFY_HEADER + TASK_HAS_FAILED);
         }
     }
+}
+
+// Long-lived worker: sleeps on the semaphore and drains the job queue
+void backgroundInterpreter(void*) {
+    InterpreterWorkData* workData;
+    
+    while (true) {
+        semaphoreWait(&interpreterJobSemaphore);
+        
+        if (interpreterThreadExit.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        workData = interpreterJobQueue.pop();
+        if (workData) {
+            runInterpreterJob(workData);
+        }
+    }
+    
+    // Drop anything that never got to run
+    while ((workData = interpreterJobQueue.pop()) != nullptr) {
+        delete workData;
+        pendingInterpreterJobs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
 
-    // Thread naturally exits here
+static void stopInterpreterWorker() {
+    if (interpreterWorkerStarted) {
+        // Signal the worker to exit once its current job is done
+        interpreterThreadExit.store(true, std::memory_order_release);
+        semaphoreSignal(&interpreterJobSemaphore);
+        
+        // Wait for thread to finish and clean up
+        threadWaitForExit(&interpreterThread);
+        threadClose(&interpreterThread);
+        interpreterWorkerStarted = false;
+    }
+    interpreterThreadExit.store(false, std::memory_order_release);
 }
 
 void closeInterpreterThread() {
-    // Signal any running thread to exit
-    interpreterThreadExit.store(true, std::memory_order_release);
-    
-    // Wait for thread to finish and clean up
-    threadWaitForExit(&interpreterThread);
-    threadClose(&interpreterThread);
+    stopInterpreterWorker();
     
     // Reset state
     clearInterpreterFlags();
-    interpreterThreadExit.store(false, std::memory_order_release);
+    runningInterpreter.store(false, std::memory_order_release);
 }
 
-int getInterpreterStackSize(const std::string& packagePath = "") {
-    #if USING_LOGGING_DIRECTIVE
-    if (!packagePath.empty()) {
-        disableLogging = !(parseValueFromIniSection(PACKAGES_INI_FILEPATH, getNameFromPath(packagePath), USE_LOGGING_STR) == TRUE_STR);
-        logFilePath = packagePath + "log.txt";
-    }
-    #endif
-    // Cache stack size parsing to avoid repeated INI file access
-    if (cachedStackSize == 0) {
-        std::string interpreterHeap = parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, MEMORY_STR, "interpreter_heap");
-
-        if (!interpreterHeap.empty()) {
-            // Strip optional "0x" or "0X" prefix
-            if (interpreterHeap.size() > 2 && interpreterHeap[0] == '0' &&
-                (interpreterHeap[1] == 'x' || interpreterHeap[1] == 'X')) {
-                interpreterHeap = interpreterHeap.substr(2);
-            }
+int getInterpreterStackSize() {
+    loadMemoryConfig();
+    return memoryConfigStackSize;
+}
 
-            // Validate remaining string is hex
-            bool validHex = !interpreterHeap.empty();
-            for (char c : interpreterHeap) {
-                if (!std::isxdigit(static_cast<unsigned char>(c))) {
-                    validHex = false;
-                    break;
-                }
-            }
 
-            if (validHex) {
-                cachedStackSize = ult::stoi(interpreterHeap, nullptr, 16);  // Convert from base 16
-            } else {
-                cachedStackSize = 0x8000;  // Default if invalid
-            }
-        } else {
-            cachedStackSize = 0x8000;  // Default if empty
+// Creates the interpreter worker on first use; it then lives until closeInterpreterThread().
+// The stack size is fixed when the thread is created, so after a [memory] stack size change
+// the worker is replaced the next time a job is queued while it is idle.
+static bool startInterpreterWorker(int stackSize) {
+    if (interpreterWorkerStarted) {
+        if (stackSize == interpreterWorkerStackSize || pendingInterpreterJobs.load(std::memory_order_acquire) != 0) {
+            return true;
         }
+        stopInterpreterWorker();
     }
-
-    return cachedStackSize;
+    
+    semaphoreInit(&interpreterJobSemaphore, 0);
+    
+    if (R_FAILED(threadCreate(&interpreterThread, backgroundInterpreter, nullptr, nullptr, stackSize, 0x2B, -2))) {
+        return false;
+    }
+    if (R_FAILED(threadStart(&interpreterThread))) {
+        threadClose(&interpreterThread);
+        return false;
+    }
+    interpreterWorkerStarted = true;
+    interpreterWorkerStackSize = stackSize;
+    return true;
 }
 
 
-
-// Combined function - creates thread with work data directly
-void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands, 
+/**
+ * @brief Queues a command list for the interpreter worker.
+ *
+ * Never waits for earlier jobs; they simply run first. The worker thread is started
+ * on the first call and reused afterwards.
+ *
+ * @param commands The commands to execute.
+ * @param packagePath The package path (optional).
+ * @param selectedCommand The selected command / section name (optional).
+ * @param onComplete Called on the worker after the job finished or was skipped (optional).
+ * @return The job id (usable with cancelInterpreterJob), or 0 if the job could not be queued.
+ */
+u32 executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands, 
                                const std::string& packagePath = "", 
-                               const std::string& selectedCommand = "") {
+                               const std::string& selectedCommand = "",
+                               InterpreterJobCallback onComplete = nullptr) {
     
-    // Wait for the existing thread to finish
-    threadWaitForExit(&interpreterThread);
-    threadClose(&interpreterThread);
-
     // Early exit if no commands
     if (commands.empty()) {
-        return;
+        return 0;
     }
 
     if (!ult::limitedMemory && ult::useSoundEffects) {
@@ -5086,33 +8710,47 @@ void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands
         ult::Audio::unloadAllSounds({ult::Audio::SoundType::Wall});
     }
     
-    // Get stack size and setup logging
-    const int stackSize = getInterpreterStackSize(packagePath);
+    const int stackSize = getInterpreterStackSize();
     
-    // Ensure exit flag is clear before starting
-    interpreterThreadExit.store(false, std::memory_order_release);
+    const u32 jobId = nextInterpreterJobId.fetch_add(1, std::memory_order_acq_rel);
+    auto workData = new InterpreterWorkData(jobId, std::move(commands), packagePath, selectedCommand, std::move(onComplete));
+    
+    // Resolve logging now but leave the globals alone: an earlier job may still be running
+    #if USING_LOGGING_DIRECTIVE
+    if (!packagePath.empty()) {
+        workData->disableLogging = !(parseValueFromIniSection(PACKAGES_INI_FILEPATH, getNameFromPath(packagePath), USE_LOGGING_STR) == TRUE_STR);
+        workData->logFilePath = packagePath + "log.txt";
+    } else {
+        workData->disableLogging = disableLogging;
+        workData->logFilePath = logFilePath;
+    }
+    #endif
     
-    // Create work data (will be cleaned up by the thread)
-    auto workData = new InterpreterWorkData(std::move(commands), packagePath, selectedCommand);
+    const bool workerStarted = startInterpreterWorker(stackSize);
     
-    // Create and start thread directly with work data
-    const int result = threadCreate(&interpreterThread, backgroundInterpreter, workData, nullptr, stackSize, 0x2B, -2);
-    if (result != 0) {
-        // Handle thread creation failure
+    // Counted before the push so the worker can never finish the job before it is counted
+    if (workerStarted) {
+        pendingInterpreterJobs.fetch_add(1, std::memory_order_acq_rel);
+    }
+    if (!workerStarted || !interpreterJobQueue.push(workData)) {
+        // Handle worker creation failure or a full queue
+        if (workerStarted) {
+            pendingInterpreterJobs.fetch_sub(1, std::memory_order_acq_rel);
+        }
         commandSuccess.store(false, std::memory_order_release);
         clearInterpreterFlags();
         runningInterpreter.store(false, std::memory_order_release);
         
-        // Clean up work data since thread won't
+        // Clean up work data since the worker won't
         delete workData;
         
         #if USING_LOGGING_DIRECTIVE
         if (!disableLogging)
-            logMessage("Failed to create interpreter thread.");
-        logFilePath = defaultLogFilePath;
-        disableLogging = true;
+            logMessage(interpreterWorkerStarted ? "Interpreter job queue is full." : "Failed to create interpreter thread.");
         #endif
-        return;
+        return 0;
     }
-    threadStart(&interpreterThread);
+    
+    semaphoreSignal(&interpreterJobSemaphore);
+    return jobId;
 }